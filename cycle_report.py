@@ -0,0 +1,173 @@
+# Cycle budgets for test/cycle_budgets.h, from the rows logged by the cycle count
+# benchmark (test/test_fast_map_cycles.cpp):
+#  * CYCLES - the fast_map() maximum for each input & output combination, over all 4
+#    range directions
+#  * CONSTANT_TIME - the fast_map_constant_time() maximum for each product width (16,
+#    24, 32 or 64 bits)
+#  * With a second log from a FAST_MAP_OPTIMIZE_SIZE build: the call overhead budget,
+#    from the largest difference between the 2 modes' fast_map() maximums
+#
+# Each budget is the measured maximum plus a small margin. The CYCLES_BUILD row of the
+# log selects the section of cycle_budgets.h (optimized or unoptimized). Run the
+# benchmark in the simulator, then print the budgets or write them in place, E.g.
+#   pio test -e megaatmega2560-O3-sim > O3.log
+#   pio test -e megaatmega2560-O3-size-sim > O3-size.log
+#   pio test -e megaatmega2560-Os-sim > Os.log
+#   python cycle_report.py --write O3.log O3-size.log
+#   python cycle_report.py --write Os.log
+#
+# --compare prints a markdown table of the inline & FAST_MAP_OPTIMIZE_SIZE modes for
+# the readme: the FLASH rows (flash_report.py, logged by the build) & the fast_map()
+# CYCLES maximums of each call site in test/test_fast_map_flash.cpp, E.g.
+#   python cycle_report.py --compare O3.log O3-size.log
+import os
+import re
+import sys
+
+TYPES = ["u8", "s8", "u16", "s16", "u32", "s32"]
+BITS = {"u8": 8, "s8": 8, "u16": 16, "s16": 16, "u32": 32, "s32": 32}
+BUDGETS_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "test", "cycle_budgets.h")
+
+
+def with_margin(cycles):
+    return cycles + (cycles // 16) + 4
+
+
+def read_rows(path, prefix):
+    # Unity prefixes each message with the file, line & test name
+    with open(path) as log:
+        for line in log:
+            if prefix in line:
+                yield line[line.index(prefix):].strip().split(",")
+
+
+def read_build(path):
+    # CYCLES_BUILD,optimized|unoptimized
+    for fields in read_rows(path, "CYCLES_BUILD,"):
+        if len(fields)>=2 and fields[1] in ("optimized", "unoptimized"):
+            return fields[1]
+    sys.exit(f"{path}: no CYCLES_BUILD row")
+
+
+def read_fast_map_cycles(path):
+    # CYCLES,in,in_direction,out,out_direction,map_max,fast_map_min,fast_map_max,...
+    cells = {}
+    for fields in read_rows(path, "CYCLES,"):
+        if len(fields)<8 or fields[1] not in TYPES:
+            continue
+        key = (fields[1], fields[3])
+        cells[key] = max(cells.get(key, 0), int(fields[7]))
+    return cells
+
+
+def read_constant_time_cycles(path):
+    # CONSTANT_TIME,in,out,direction,min,max,spread,budget,status
+    widths = {}
+    for fields in read_rows(path, "CONSTANT_TIME,"):
+        if len(fields)<6 or fields[1] not in TYPES:
+            continue
+        # Any 32-bit type needs a 64-bit product
+        width = BITS[fields[1]] + BITS[fields[2]]
+        width = width if width<=32 else 64
+        widths[width] = max(widths.get(width, 0), int(fields[5]))
+    return widths
+
+
+def read_all_cells(path):
+    cells = read_fast_map_cycles(path)
+    if len(cells)!=len(TYPES)*len(TYPES):
+        sys.exit(f"{path}: expected {len(TYPES)*len(TYPES)} type combinations, found {len(cells)}")
+    return cells
+
+
+def budget_lines(path):
+    cells = read_all_cells(path)
+    lines = ["static const uint16_t fast_map_cycle_budgets[6][6] = {",
+             "    //" + "".join(f"{name:>7}" for name in TYPES)]
+    for inType in TYPES:
+        row = ", ".join(f"{with_margin(cells[(inType, outType)]):5}" for outType in TYPES)
+        lines.append(f"    {{{row} }}, // {inType}")
+    lines.append("};")
+    for width, cycles in sorted(read_constant_time_cycles(path).items()):
+        lines.append(f"static const uint16_t fast_map_constant_time_budget_{width} = {with_margin(cycles)};")
+    return lines
+
+
+def overhead_lines(path, sizePath):
+    cells = read_all_cells(path)
+    sizeCells = read_all_cells(sizePath)
+    overhead = max(sizeCells[key] - cells[key] for key in cells)
+    return [f"static const uint16_t fast_map_call_overhead_budget = {with_margin(max(overhead, 0))};"]
+
+
+def read_flash(path):
+    # FLASH,mode,call|kernel|total,name,bytes
+    rows = {}
+    for fields in read_rows(path, "FLASH,"):
+        if len(fields)==5:
+            rows[(fields[2], fields[3])] = int(fields[4])
+    if not rows:
+        sys.exit(f"{path}: no FLASH rows (build with flash_report.py)")
+    return rows
+
+
+def print_comparison(path, sizePath):
+    flash = read_flash(path)
+    sizeFlash = read_flash(sizePath)
+    cells = read_all_cells(path)
+    sizeCells = read_all_cells(sizePath)
+
+    print("| Types | Call site bytes (inline) | Call site bytes (size) | Max cycles (inline) | Max cycles (size) |")
+    print("|-------|-------------------------:|-----------------------:|--------------------:|------------------:|")
+    for kind, name in sorted(flash):
+        if kind!="call":
+            continue
+        inType, outType = name.split("_")
+        print(f"| {inType} to {outType} | {flash[(kind, name)]} | {sizeFlash.get((kind, name), '-')} "
+              f"| {cells[(inType, outType)]} | {sizeCells[(inType, outType)]} |")
+    print(f"| Shared kernels | - | {sizeFlash.get(('total', 'kernels'), 0)} | - | - |")
+
+
+def replace_section(text, name, lines):
+    # The generated lines sit between "// cycle_report.py: begin <name>" & the matching end
+    pattern = re.compile(rf"(// cycle_report\.py: begin {name}\n).*?(// cycle_report\.py: end {name}\n)", re.S)
+    if not pattern.search(text):
+        sys.exit(f"{BUDGETS_PATH}: no '{name}' section")
+    return pattern.sub(lambda match: match.group(1) + "\n".join(lines) + "\n" + match.group(2), text)
+
+
+def report(path, sizePath, write):
+    build = read_build(path)
+    sections = [(build, budget_lines(path))]
+    if sizePath:
+        if read_build(sizePath)!=build:
+            sys.exit(f"{sizePath}: not the same build as {path}")
+        sections.append(("overhead", overhead_lines(path, sizePath)))
+
+    if not write:
+        for name, lines in sections:
+            print(f"// {name}")
+            print("\n".join(lines))
+        return
+
+    with open(BUDGETS_PATH) as budgets:
+        text = budgets.read()
+    for name, lines in sections:
+        text = replace_section(text, name, lines)
+    with open(BUDGETS_PATH, "w") as budgets:
+        budgets.write(text)
+    print(f"Updated {', '.join(name for name, _ in sections)} in {BUDGETS_PATH}")
+
+
+if __name__=="__main__":
+    args = sys.argv[1:]
+    write = "--write" in args
+    compare = "--compare" in args
+    args = [arg for arg in args if arg not in ("--write", "--compare")]
+    if compare and len(args)==2:
+        print_comparison(args[0], args[1])
+    elif not compare and len(args) in (1, 2):
+        report(args[0], args[1] if len(args)==2 else None, write)
+    else:
+        sys.exit("usage: python cycle_report.py [--write] <test log> [<FAST_MAP_OPTIMIZE_SIZE test log>]\n"
+                 "       python cycle_report.py --compare <test log> <FAST_MAP_OPTIMIZE_SIZE test log>")
@@ -0,0 +1,49 @@
+Import("env")
+
+# Flash bytes used by fast_map(), from the firmware symbol table:
+#  * fast_map_flash_* - the probes in test/test_fast_map_flash.cpp: one per type
+#    combination, so each is the cost of one call site (the whole fast_map() body
+#    when inlined, only argument marshalling with FAST_MAP_OPTIMIZE_SIZE)
+#  * mapKernel - the shared out of line kernels (FAST_MAP_OPTIMIZE_SIZE only): one
+#    per input & output width, paid once per firmware
+#
+# Build both modes & compare, E.g.
+#   pio test -e megaatmega2560-O3-sim --without-uploading --without-testing
+#   pio test -e megaatmega2560-O3-size-sim --without-uploading --without-testing
+def fast_map_flash_report(source, target, env):
+    import os
+    import subprocess
+
+    nm = env.subst("$OBJCOPY").replace("objcopy", "nm")
+    elf = str(target[0])
+    try:
+        symbols = subprocess.check_output([nm, "--size-sort", "-S", "-C", elf], universal_newlines=True)
+    except (OSError, subprocess.CalledProcessError) as error:
+        print(f"fast_map flash report skipped: {error}")
+        return
+
+    probes = []
+    kernels = []
+    for line in symbols.splitlines():
+        # <address> <size> <type> <name>
+        fields = line.split(None, 3)
+        if len(fields)!=4:
+            continue
+        size = int(fields[1], 16)
+        name = fields[3]
+        if name.startswith("fast_map_flash_"):
+            probes.append((name[len("fast_map_flash_"):].split("(")[0], size))
+        elif "fast_map_impl::mapKernel<" in name:
+            # E.g. "mapKernel<unsigned char, unsigned int>(...)" -> "unsigned char:unsigned int"
+            kernels.append((name.split("mapKernel<")[1].split(">(")[0].replace(", ", ":"), size))
+
+    mode = "size" if kernels else "inline"
+    print(f"fast_map flash report ({mode}): {os.path.basename(elf)}")
+    for name, size in sorted(probes):
+        print(f"  FLASH,{mode},call,{name},{size}")
+    for name, size in sorted(kernels):
+        print(f"  FLASH,{mode},kernel,{name},{size}")
+    print(f"  FLASH,{mode},total,calls,{sum(size for _, size in probes)}")
+    print(f"  FLASH,{mode},total,kernels,{sum(size for _, size in kernels)}")
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", fast_map_flash_report)
@@ -0,0 +1,285 @@
+#pragma once
+
+#include "avr-fast-map.h"
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+
+/**
+ * @file
+ * @brief Map many channels (E.g. sensor inputs), each with its own ranges.
+ */
+
+/**
+ * @brief The calibration of a fast_map_bank: the ranges of each channel.
+ *
+ * Struct of arrays, with no padding or flags: so this is the compact form to store
+ * in flash (PROGMEM) or EEPROM & load into the bank at start up. E.g.
+ * @code
+ * static const fast_map_bank_ranges<3, uint16_t, int16_t> calibration FAST_MAP_PROGMEM = {
+ *     { 0, 0, 102 },          // inMin
+ *     { 1023, 1023, 921 },    // inMax
+ *     { -40, 0, 0 },          // outMin
+ *     { 150, 5000, 100 },     // outMax
+ * };
+ * @endcode
+ *
+ * @tparam N Number of channels
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <uint8_t N, typename TIn, typename TOut>
+struct fast_map_bank_ranges {
+    /** @brief Input range minimum, per channel */
+    TIn inMin[N];
+    /** @brief Input range maximum, per channel (must not equal inMin) */
+    TIn inMax[N];
+    /** @brief Output range minimum, per channel */
+    TOut outMin[N];
+    /** @brief Output range maximum, per channel */
+    TOut outMax[N];
+};
+
+/// @cond
+namespace fast_map_impl {
+
+    struct sram_reader {
+        template <typename T>
+        static inline T read(const T *pSrc) {
+            return *pSrc;
+        }
+    };
+
+    // Read a value from flash (on AVR)
+    struct progmem_reader {
+        template <typename T>
+        static inline T read(const T *pSrc) {
+#if defined(__AVR__)
+            T value;
+            memcpy_P(&value, pSrc, sizeof(T));
+            return value;
+#else
+            return *pSrc;
+#endif
+        }
+    };
+
+#if defined(__AVR__)
+    struct eeprom_reader {
+        template <typename T>
+        static inline T read(const T *pSrc) {
+            T value;
+            eeprom_read_block(&value, pSrc, sizeof(T));
+            return value;
+        }
+    };
+#endif
+
+    // fast_map_bank's per channel scaling: (m * outRange) / inRange
+    template <uint8_t N, typename TInRange, typename TOutRange, bool cacheReciprocal>
+    class bank_scaler;
+
+    // Stores the 2 ranges: a division per map() call (as fast_map())
+    template <uint8_t N, typename TInRange, typename TOutRange>
+    class bank_scaler<N, TInRange, TOutRange, false> {
+    public:
+        void set(uint8_t channel, const TInRange &inRange, const TOutRange &outRange) {
+            _inRange[channel] = inRange;
+            _outRange[channel] = outRange;
+        }
+
+        TOutRange scale(uint8_t channel, const TInRange &m) const {
+            return mulDivReciprocal(m, _outRange[channel], _inRange[channel]);
+        }
+
+    private:
+        TInRange _inRange[N];
+        TOutRange _outRange[N];
+    };
+
+    // Stores the input range & the pre-computed quotient & reciprocal (as fast_mapper):
+    // no division for in range inputs
+    template <uint8_t N, typename TInRange, typename TOutRange>
+    class bank_scaler<N, TInRange, TOutRange, true> {
+    public:
+        void set(uint8_t channel, const TInRange &inRange, const TOutRange &outRange) {
+            _inRange[channel] = inRange;
+            // outRange == (_quotient * _inRange) + remainder
+            _quotient[channel] = (TOutRange)(outRange / inRange);
+            _recip[channel] = fixedPointReciprocal((TInRange)(outRange % inRange), inRange);
+        }
+
+        TOutRange scale(uint8_t channel, const TInRange &m) const {
+            if (m<=_inRange[channel]) {
+                return scaleByReciprocal(m, _quotient[channel], _recip[channel]);
+            }
+            // Out of range input: this is rare, so use the slow path. The output range is 
+            // the in range result for m==_inRange, which is exact.
+            const TOutRange outRange = scaleByReciprocal(_inRange[channel], _quotient[channel], _recip[channel]);
+            return (TOutRange)mulDiv(m, outRange, _inRange[channel]);
+        }
+
+    private:
+        TInRange _inRange[N];
+        TOutRange _quotient[N];
+        widen_integral_t<TInRange> _recip[N];
+    };
+}
+/// @endcond
+
+/**
+ * @brief A bank of mappers, one per channel, indexed by channel number.
+ *
+ * Results are identical to fast_map(). By default each channel stores inMin, outMin
+ * & the input & output ranges (plus a direction bit): the same SRAM as the raw ranges
+ * (E.g. 8 bytes per channel for 16-bit types), but the range calculations & direction
+ * checks are done when a channel's ranges are set. map() still divides, like 
+ * fast_map().
+ *
+ * With CacheReciprocal, each channel stores the pre-computed quotient & reciprocal
+ * instead of the output range, like fast_mapper: in range inputs need no division.
+ * This trades SRAM for speed: E.g. 12 bytes per channel for 16-bit types. The output
+ * range isn't stored: the rare out of range inputs recompute it.
+ *
+ * The values are stored as a struct of arrays, with the direction flags packed 8 to a
+ * byte: so there is no per channel flag byte or padding. The raw ranges aren't kept:
+ * they can stay in flash or EEPROM (see fast_map_bank_ranges) & are only read when
+ * loading.
+ *
+ * @tparam N Number of channels
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @tparam CacheReciprocal Store each channel's reciprocal, to avoid the division
+ */
+template <uint8_t N, typename TIn, typename TOut, bool CacheReciprocal = false>
+class fast_map_bank {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+public:
+    /** @brief The calibration layout for this bank */
+    typedef fast_map_bank_ranges<N, TIn, TOut> ranges_t;
+
+    /**
+     * @brief Construct a new bank: all channels map to 0 until their ranges are set.
+     */
+    fast_map_bank(void) {
+        for (uint8_t channel=0; channel<N; ++channel) {
+            set(channel, (TIn)0, (TIn)1, (TOut)0, (TOut)0);
+        }
+    }
+
+    /**
+     * @brief Construct a new bank from ranges in RAM
+     *
+     * @param ranges Ranges for all channels
+     */
+    explicit fast_map_bank(const ranges_t &ranges) {
+        load(ranges);
+    }
+
+    /**
+     * @brief Set the ranges of one channel
+     *
+     * With CacheReciprocal, this does the same pre-computation as the fast_mapper 
+     * constructor (so it is slower than a map() call).
+     *
+     * @param channel Channel index (less than N)
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    void set(uint8_t channel, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+        _inMin[channel] = inMin;
+        _outMin[channel] = outMin;
+        _scaler.set(channel, fast_map_impl::absDelta(inMin, inMax), fast_map_impl::absDelta(outMin, outMax));
+        const uint8_t mask = (uint8_t)(1U << (channel & 7U));
+        if ((inMax<inMin)!=(outMax<outMin)) {
+            _opposed[channel >> 3U] = (uint8_t)(_opposed[channel >> 3U] | mask);
+        } else {
+            _opposed[channel >> 3U] = (uint8_t)(_opposed[channel >> 3U] & (uint8_t)~mask);
+        }
+    }
+
+    /**
+     * @brief Set the ranges of all channels from RAM
+     *
+     * @param ranges Ranges for all channels
+     */
+    void load(const ranges_t &ranges) {
+        loadFrom<fast_map_impl::sram_reader>(&ranges);
+    }
+
+    /**
+     * @brief Set the ranges of all channels from flash (PROGMEM)
+     *
+     * The ranges are read one value at a time, so no RAM copy of the ranges is needed.
+     *
+     * @param pRanges Ranges for all channels, declared FAST_MAP_PROGMEM
+     */
+    void load_P(const ranges_t *pRanges) {
+        loadFrom<fast_map_impl::progmem_reader>(pRanges);
+    }
+
+#if defined(__AVR__)
+    /**
+     * @brief Set the ranges of all channels from EEPROM
+     *
+     * The ranges are read one value at a time, so no RAM copy of the ranges is needed.
+     *
+     * @param pRanges Address of the ranges in EEPROM (E.g. an EEMEM variable)
+     */
+    void load_eeprom(const ranges_t *pRanges) {
+        loadFrom<fast_map_impl::eeprom_reader>(pRanges);
+    }
+#endif
+
+    /**
+     * @brief Map a value from a channel's input range to its output range
+     *
+     * @param channel Channel index (less than N)
+     * @param in Input value
+     * @return TOut
+     */
+    TOut map(uint8_t channel, TIn in) const {
+        const in_unsigned_t m = fast_map_impl::absDelta(_inMin[channel], in);
+        const out_unsigned_t scaled = _scaler.scale(channel, m);
+        if ((in<_inMin[channel])!=isOpposed(channel)) {
+            return (TOut)(_outMin[channel] - scaled);
+        }
+        return (TOut)(_outMin[channel] + scaled);
+    }
+
+    /**
+     * @brief Map one value per channel: out[i] = map(i, in[i]) for all N channels.
+     *
+     * @param in Input values, one per channel
+     * @param out Output values, one per channel
+     */
+    void map_all(const TIn *in, TOut *out) const {
+        for (uint8_t channel=0; channel<N; ++channel) {
+            out[channel] = map(channel, in[channel]);
+        }
+    }
+
+private:
+    template <typename TReader>
+    void loadFrom(const ranges_t *pRanges) {
+        for (uint8_t channel=0; channel<N; ++channel) {
+            set(channel,
+                TReader::read(&pRanges->inMin[channel]), TReader::read(&pRanges->inMax[channel]),
+                TReader::read(&pRanges->outMin[channel]), TReader::read(&pRanges->outMax[channel]));
+        }
+    }
+
+    bool isOpposed(uint8_t channel) const {
+        return (_opposed[channel >> 3U] & (uint8_t)(1U << (channel & 7U)))!=0U;
+    }
+
+    TIn _inMin[N];
+    TOut _outMin[N];
+    fast_map_impl::bank_scaler<N, in_unsigned_t, out_unsigned_t, CacheReciprocal> _scaler;
+    // Ranges opposed flags, 1 bit per channel
+    uint8_t _opposed[(N+7U)/8U] = {};
+};
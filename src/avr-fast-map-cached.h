@@ -0,0 +1,136 @@
+#pragma once
+
+#include "avr-fast-map-iterator.h"
+
+/**
+ * @file
+ * @brief A mapper that remembers the last result, for inputs that rarely change
+ * (E.g. ADC readings polled every loop).
+ */
+
+/**
+ * @brief A mapper for a fixed set of ranges that caches the last input & output.
+ *
+ * Each map() call is one of:
+ *  * A cache hit: the input is unchanged (or within the hysteresis band of the last
+ *    input). The cached output is returned.
+ *  * A single step: the input moved by 1. The output is updated by adding the slope
+ *    (a pre-computed quotient & remainder), without a division.
+ *  * A miss: the output is recomputed using fast_map()'s multiply & divide.
+ *
+ * With no hysteresis, results are identical to fast_map(). With hysteresis, the output
+ * is only updated once the input moves more than the hysteresis away from the input
+ * that produced the cached output: so small jitter in the input doesn't change the
+ * output (or cost a division).
+ *
+ * Build with FAST_MAP_STATISTICS defined to count each kind of call (see 
+ * statistics()): E.g. to tune the hysteresis. The counters cost a few cycles per call.
+ *
+ * @note The cache makes map() non-const and not re-entrant: don't share a
+ * mapper between an ISR and the main loop.
+ *
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <typename TIn, typename TOut>
+class fast_cached_mapper {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+
+public:
+    /**
+     * @brief Construct a new mapper object
+     *
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     * @param hysteresis Input changes of this size or smaller return the cached output
+     */
+    fast_cached_mapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax, in_unsigned_t hysteresis = 0U)
+        // The initial state is the mapping of inMin: position 0, output outMin
+        : _position(fast_map_impl::absDelta(inMin, inMax), fast_map_impl::absDelta(outMin, outMax), 1U)
+        , _inMin(inMin)
+        , _outMin(outMin)
+        , _hysteresis(hysteresis)
+        , _lastIn(inMin)
+        , _lastOut(outMin)
+        , _inRangeInverted(inMax<inMin)
+        , _outRangeInverted(outMax<outMin)
+    {
+    }
+
+    /**
+     * @brief Map a value, using the cached result if possible
+     *
+     * @param in Input value
+     * @return TOut
+     */
+    TOut map(TIn in) {
+        if (in==_lastIn) {
+#if defined(FAST_MAP_STATISTICS)
+            ++_statistics.hits;
+#endif
+            return _lastOut;
+        }
+        const in_unsigned_t delta = fast_map_impl::absDelta(_lastIn, in);
+        if (delta<=_hysteresis) {
+#if defined(FAST_MAP_STATISTICS)
+            ++_statistics.hits;
+#endif
+            return _lastOut;
+        }
+        if (delta==1U) {
+#if defined(FAST_MAP_STATISTICS)
+            ++_statistics.steps;
+#endif
+            _position.step((_lastIn<in)!=_inRangeInverted);
+        } else {
+#if defined(FAST_MAP_STATISTICS)
+            ++_statistics.misses;
+#endif
+            _position.seek(fast_map_impl::absDelta(_inMin, in), (in<_inMin)!=_inRangeInverted);
+        }
+        _lastIn = in;
+        _lastOut = _position.value(_outMin, _outRangeInverted);
+        return _lastOut;
+    }
+
+#if defined(FAST_MAP_STATISTICS)
+    /**
+     * @brief Counts of each kind of map() call. The counters wrap.
+     */
+    struct statistics_t {
+        /// @brief Cached output returned (including inputs within the hysteresis)
+        uint16_t hits;
+        /// @brief Output updated by a single step
+        uint16_t steps;
+        /// @brief Output recomputed with a division
+        uint16_t misses;
+    };
+
+    /**
+     * @brief The map() call counts since construction or reset_statistics()
+     *
+     * @return const statistics_t&
+     */
+    const statistics_t& statistics(void) const { return _statistics; }
+
+    /**
+     * @brief Zero the map() call counts
+     */
+    void reset_statistics(void) { _statistics = statistics_t(); }
+#endif
+
+private:
+    fast_map_impl::scaled_position<TIn, TOut> _position;
+    TIn _inMin;
+    TOut _outMin;
+    in_unsigned_t _hysteresis;
+    TIn _lastIn;
+    TOut _lastOut;
+    bool _inRangeInverted;
+    bool _outRangeInverted;
+#if defined(FAST_MAP_STATISTICS)
+    statistics_t _statistics = {};
+#endif
+};
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "avr-fast-map.h"
+
+/**
+ * @file
+ * @brief Compose a chain of linear mappings (E.g. ADC counts => millivolts => kPa)
+ * into a single mapping.
+ *
+ * Mapping in stages costs one fast_map() call per stage, each with its own
+ * division & its own truncation. The composition of linear maps is itself linear,
+ * so the whole chain can be replaced with one map. The ranges of the composed map
+ * are usually not integers: so the input is first multiplied by a constant (the
+ * scale) that makes them integral.
+ *
+ * Truncation: the composed map rounds once, at the end. The result is the exact
+ * (infinite precision) chain of maps, truncated towards the final outMin - the same
+ * rounding as fast_map(). Chained fast_map() calls truncate at each stage, so their
+ * result can differ (by 1 or more, depending on the ranges). When all ranges are
+ * ascending, the chained result is never higher than the composed one.
+ */
+
+/**
+ * @brief The ranges of one stage in a chain of maps: the arguments of a fast_map() call.
+ */
+struct fast_map_ranges {
+    /** @brief Input range minimum */
+    int32_t inMin;
+    /** @brief Input range maximum (must not equal inMin) */
+    int32_t inMax;
+    /** @brief Output range minimum */
+    int32_t outMin;
+    /** @brief Output range maximum */
+    int32_t outMax;
+};
+
+/**
+ * @brief A chain of maps composed into a single map, from fast_map_compose().
+ *
+ * Maps in to: outMin + ((scale * in) - inMin) * outRange / inRange
+ *
+ * All values are reduced to their lowest terms.
+ */
+struct fast_map_composition {
+    /** @brief Multiplier for the input */
+    int64_t scale;
+    /** @brief Scaled input range minimum */
+    int64_t inMin;
+    /** @brief Scaled input range size (negative if the range is inverted) */
+    int64_t inRange;
+    /** @brief Output range minimum */
+    int64_t outMin;
+    /** @brief Output range size (negative if the range is inverted) */
+    int64_t outRange;
+    /** @brief Input range of the first stage: the inputs the fast path is used for */
+    int32_t firstInMin;
+    /** @brief Input range of the first stage: the inputs the fast path is used for */
+    int32_t firstInMax;
+};
+
+/// @cond
+namespace fast_map_impl {
+
+    static inline constexpr int64_t constGcd(int64_t a, int64_t b) {
+        return b==0 ? (a<0 ? -a : a) : constGcd(b, a % b);
+    }
+
+    // Divide the input side (scale, inMin & inRange) by their common factor
+    static inline constexpr fast_map_composition reduceInput(const fast_map_composition &c, int64_t factor) {
+        return fast_map_composition { c.scale/factor, c.inMin/factor, c.inRange/factor, c.outMin, c.outRange, c.firstInMin, c.firstInMax };
+    }
+
+    // Divide inRange & outRange by their common factor
+    static inline constexpr fast_map_composition reduceRanges(const fast_map_composition &c, int64_t factor) {
+        return fast_map_composition { c.scale, c.inMin, c.inRange/factor, c.outMin, c.outRange/factor, c.firstInMin, c.firstInMax };
+    }
+
+    // Reduce to lowest terms: the map is exactly the same, but needs narrower types
+    static inline constexpr fast_map_composition reduce(const fast_map_composition &c) {
+        return reduceInput(c, constGcd(c.scale, constGcd(c.inMin, c.inRange)));
+    }
+    static inline constexpr fast_map_composition reduceAll(const fast_map_composition &c) {
+        return reduce(reduceRanges(c, constGcd(c.inRange, c.outRange)));
+    }
+
+    static inline constexpr fast_map_composition toComposition(const fast_map_ranges &r) {
+        return reduceAll(fast_map_composition { 1, r.inMin, (int64_t)r.inMax-r.inMin, r.outMin, (int64_t)r.outMax-r.outMin, r.inMin, r.inMax });
+    }
+
+    // second(first(in)). With first(x) = o + (k*x - K0)*R/K1 & second(y) = o' + (k'*y - K0')*R'/K1':
+    //   second(first(x)) = o' + (k'*R*k*x - (k'*R*K0 - (k'*o - K0')*K1)) * R' / (K1*K1')
+    static inline constexpr fast_map_composition compose(const fast_map_composition &first, const fast_map_composition &second) {
+        return reduceAll(fast_map_composition {
+            second.scale * first.outRange * first.scale,
+            (second.scale * first.outRange * first.inMin) - ((second.scale * first.outMin) - second.inMin) * first.inRange,
+            first.inRange * second.inRange,
+            second.outMin,
+            second.outRange,
+            first.firstInMin,
+            first.firstInMax });
+    }
+
+    // Inputs outside the first stage's input range: the scaled input may not fit
+    // the narrow type used for in range inputs, so use 64-bit arithmetic. This is rare,
+    // so the speed doesn't matter.
+    //
+    // m can be wider than 32 bits, so m * outRange can overflow 64 bits. Split m into
+    // (quotient * inRange) + remainder: remainder * outRange always fits in 64 bits.
+    template <typename TOut>
+    static inline TOut composedMapWide(int64_t scaledIn, int64_t inMin, uint32_t inRange, bool rangesOpposed,
+                                       TOut outMin, fast_map_impl::make_unsigned_t<TOut> outRange) {
+        static_assert(sizeof(TOut)<=sizeof(uint32_t), "Composed ranges must fit in 32 bits");
+        typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+        const uint64_t m = absDelta(inMin, scaledIn);
+        const uint64_t quotient = divide(m, inRange);
+        const uint32_t remainder = (uint32_t)(m - (quotient * inRange));
+        // Same as the low bits of the full quotient, even if the result overflows
+        const out_unsigned_t scaled = (out_unsigned_t)((quotient * outRange) + mulDiv(remainder, (uint32_t)outRange, inRange));
+        if ((scaledIn<inMin)!=rangesOpposed) {
+            return (TOut)(outMin - scaled);
+        }
+        return (TOut)(outMin + scaled);
+    }
+
+    static inline constexpr int32_t constMin(int32_t a, int32_t b) { return a<b ? a : b; }
+    static inline constexpr int32_t constMax(int32_t a, int32_t b) { return a<b ? b : a; }
+    static inline constexpr bool fitsInt32(int64_t value) { return value>=INT32_MIN && value<=INT32_MAX; }
+
+    // Compile time composition of constant ranges: 4 values (inMin, inMax, outMin, outMax) per stage
+    template <int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax, int32_t... rest>
+    struct const_composition {
+        static constexpr fast_map_composition value(void) {
+            return compose(toComposition(fast_map_ranges { inMin, inMax, outMin, outMax }), const_composition<rest...>::value());
+        }
+        typedef typename const_composition<rest...>::out_t out_t;
+    };
+
+    template <int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax>
+    struct const_composition<inMin, inMax, outMin, outMax> {
+        static constexpr fast_map_composition value(void) {
+            return toComposition(fast_map_ranges { inMin, inMax, outMin, outMax });
+        }
+        typedef narrowest_integral_t<outMin, outMax> out_t;
+    };
+
+    template <int32_t... ranges>
+    struct const_composed_map {
+        typedef const_composition<ranges...> composition_t;
+        typedef typename composition_t::out_t out_t;
+
+        static constexpr int64_t scale = composition_t::value().scale;
+        static constexpr int64_t inMin = composition_t::value().inMin;
+        static constexpr int64_t inMax = composition_t::value().inMin + composition_t::value().inRange;
+        static constexpr int64_t outMin = composition_t::value().outMin;
+        static constexpr int64_t outMax = composition_t::value().outMin + composition_t::value().outRange;
+        static constexpr int32_t firstInLow = constMin(composition_t::value().firstInMin, composition_t::value().firstInMax);
+        static constexpr int32_t firstInHigh = constMax(composition_t::value().firstInMin, composition_t::value().firstInMax);
+
+        static_assert(fitsInt32(scale*firstInLow) && fitsInt32(scale*firstInHigh) && fitsInt32(inMin) && fitsInt32(inMax)
+                   && fitsInt32(outMin) && fitsInt32(outMax), "Composed ranges must fit in 32 bits");
+
+        // Holds the scaled input (for inputs within the first stage's range) & the
+        // scaled input range
+        typedef narrowest_integral_t<constMin(constMin((int32_t)(scale*firstInLow), (int32_t)(scale*firstInHigh)), constMin((int32_t)inMin, (int32_t)inMax)),
+                                     constMax(constMax((int32_t)(scale*firstInLow), (int32_t)(scale*firstInHigh)), constMax((int32_t)inMin, (int32_t)inMax))> scaled_t;
+    };
+}
+/// @endcond
+
+/**
+ * @brief Compose 2 maps into a single map: the output of the first is the input of
+ * the second.
+ *
+ * A constexpr function, so the composition can be done at compile time. E.g.
+ * @code
+ * // ADC counts => millivolts => kPa
+ * static const fast_composed_mapper<uint16_t, uint8_t> adcToKpa(
+ *     fast_map_compose({ 0, 1023, 0, 5000 }, { 500, 4500, 0, 100 }));
+ * @endcode
+ *
+ * @param first The first stage
+ * @param second The second stage
+ * @return fast_map_composition
+ */
+static inline constexpr fast_map_composition fast_map_compose(const fast_map_ranges &first, const fast_map_ranges &second) {
+    return fast_map_impl::compose(fast_map_impl::toComposition(first), fast_map_impl::toComposition(second));
+}
+
+/**
+ * @brief Compose 3 maps into a single map.
+ *
+ * @param first The first stage
+ * @param second The second stage
+ * @param third The third stage
+ * @return fast_map_composition
+ */
+static inline constexpr fast_map_composition fast_map_compose(const fast_map_ranges &first, const fast_map_ranges &second, const fast_map_ranges &third) {
+    return fast_map_impl::compose(fast_map_compose(first, second), fast_map_impl::toComposition(third));
+}
+
+/**
+ * @brief Add a stage to the end of a composed map: for chains of any length. E.g.
+ * @code
+ * fast_map_compose_append(fast_map_compose(first, second, third), fourth)
+ * @endcode
+ *
+ * @param composition The stages so far
+ * @param next The next stage
+ * @return fast_map_composition
+ */
+static inline constexpr fast_map_composition fast_map_compose_append(const fast_map_composition &composition, const fast_map_ranges &next) {
+    return fast_map_impl::compose(composition, fast_map_impl::toComposition(next));
+}
+
+/**
+ * @brief A chain of maps, composed into a single map at setup time.
+ *
+ * Each map() call is the fast_mapper::map() kernel, plus a multiply of the input by
+ * the composition's scale. Inputs outside the first stage's input range use a slower
+ * 64-bit calculation.
+ *
+ * Results are identical to fast_map_composed(): see the file description for
+ * the rounding.
+ *
+ * @tparam TIn Input type (of the first stage)
+ * @tparam TOut Output type (of the last stage)
+ * @tparam TScaled Type of the scaled input: must hold the composition's scale times the
+ * first stage's inMin & inMax, and the composed input range. A narrower type is faster.
+ */
+template <typename TIn, typename TOut, typename TScaled = int32_t>
+class fast_composed_mapper : private fast_mapper<TScaled, TOut> {
+    typedef fast_mapper<TScaled, TOut> base_t;
+    static_assert(sizeof(TScaled)<=sizeof(int32_t) && sizeof(TOut)<=sizeof(int32_t), "Composed ranges must fit in 32 bits");
+
+public:
+    /**
+     * @brief Construct a new mapper object
+     *
+     * @param composition From fast_map_compose()
+     */
+    fast_composed_mapper(const fast_map_composition &composition)
+        : base_t((TScaled)composition.inMin, (TScaled)(composition.inMin + composition.inRange),
+                 (TOut)composition.outMin, (TOut)(composition.outMin + composition.outRange))
+        , _scale((TScaled)composition.scale)
+        , _firstInLow((TIn)fast_map_impl::constMin(composition.firstInMin, composition.firstInMax))
+        , _firstInHigh((TIn)fast_map_impl::constMax(composition.firstInMin, composition.firstInMax))
+    {
+    }
+
+    /**
+     * @brief Map a value through all stages
+     *
+     * @param in Input value
+     * @return TOut
+     */
+    TOut map(TIn in) const {
+        if (in>=_firstInLow && in<=_firstInHigh) {
+            return base_t::map((TScaled)((TScaled)in * _scale));
+        }
+        return fast_map_impl::composedMapWide((int64_t)in * _scale, (int64_t)this->_inMin, (uint32_t)this->_inRange, this->_rangesOpposed,
+                                              this->_outMin, this->_outRange);
+    }
+
+private:
+    TScaled _scale;
+    TIn _firstInLow;
+    TIn _firstInHigh;
+};
+
+/**
+ * @brief A chain of maps with constant ranges, composed at compile time.
+ *
+ * The ranges are 4 values per stage: inMin, inMax, outMin, outMax. E.g.
+ * @code
+ * // ADC counts => millivolts => kPa
+ * uint8_t kPa = fast_map_composed<0, 1023, 0, 5000,  500, 4500, 0, 100>(analogRead(A0));
+ * @endcode
+ *
+ * The composed map is a multiply of the input by a constant, then the constant range
+ * fast_map<>() kernel (no division for inputs within the first stage's input range).
+ * The types are selected at compile time. Inputs outside the first stage's input range
+ * use a slower 64-bit calculation.
+ *
+ * See the file description for the rounding.
+ *
+ * @tparam ranges inMin, inMax, outMin, outMax for each stage, in order
+ * @tparam TIn Input type
+ * @param in Input value
+ * @return The narrowest type that can hold the last stage's output range
+ */
+template <int32_t... ranges, typename TIn>
+static inline typename fast_map_impl::const_composed_map<ranges...>::out_t fast_map_composed(TIn in) {
+    typedef fast_map_impl::const_composed_map<ranges...> map_t;
+    typedef typename map_t::out_t out_t;
+    typedef typename map_t::scaled_t scaled_t;
+    static_assert(fast_map_impl::isRepresentable<TIn>(map_t::firstInLow) && fast_map_impl::isRepresentable<TIn>(map_t::firstInHigh),
+                  "The first stage's input range must fit in the input type");
+
+    if (in>=(TIn)map_t::firstInLow && in<=(TIn)map_t::firstInHigh) {
+        return fast_map<(int32_t)map_t::inMin, (int32_t)map_t::inMax, (int32_t)map_t::outMin, (int32_t)map_t::outMax, out_t>(
+                    (scaled_t)((scaled_t)in * (scaled_t)map_t::scale));
+    }
+    typedef typename fast_map_impl::make_unsigned_t<out_t> out_unsigned_t;
+    return fast_map_impl::composedMapWide((int64_t)in * map_t::scale, map_t::inMin,
+                                          (uint32_t)fast_map_impl::constAbsDelta((int32_t)map_t::inMin, (int32_t)map_t::inMax),
+                                          (map_t::inMax<map_t::inMin)!=(map_t::outMax<map_t::outMin),
+                                          (out_t)map_t::outMin, (out_unsigned_t)fast_map_impl::constAbsDelta((int32_t)map_t::outMin, (int32_t)map_t::outMax));
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "avr-fast-map.h"
+
+/**
+ * @file
+ * @brief Piecewise linear interpolation over a curve of calibration points, using fast_map().
+ */
+
+/// @cond
+namespace fast_map_impl {
+
+    // Narrowest type that can index an array of N elements
+    template <uint16_t N>
+    using bin_index_t = typename type_traits::conditional<(N<=UINT8_MAX), uint8_t, uint16_t>::type;
+
+    // Find the bin containing an input: i.e. the largest bin where axis[bin]<=in
+    //
+    // Small axes use a linear search, larger axes a binary search.
+    //
+    // Pre-condition: axis[0]<in<axis[N-1] & axis is strictly increasing
+    template <typename TAxis, uint16_t N>
+    static inline bin_index_t<N> findBin(const TAxis (&axis)[N], const TAxis &in) {
+        // Axes with this many break points or fewer use a linear search
+        constexpr uint8_t linear_search_max = 8U;
+        typedef bin_index_t<N> bin_t;
+
+        if (N<=linear_search_max) {
+            bin_t bin = 0U;
+            while (in>=axis[bin+1U]) {
+                ++bin;
+            }
+            return bin;
+        }
+        // Invariant: axis[low]<=in<axis[high]
+        bin_t low = 0U;
+        bin_t high = (bin_t)(N-1U);
+        while ((bin_t)(high-low)>1U) {
+            const bin_t mid = (bin_t)(low + ((bin_t)(high-low) >> 1U));
+            if (in>=axis[mid]) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+}
+/// @endcond
+
+/**
+ * @brief A curve, defined by N (axis, value) break points.
+ * 
+ * Inputs are linearly interpolated between the 2 nearest break points, using fast_map().
+ * Inputs outside the axis range are clamped to the first or last value.
+ * 
+ * The bin (pair of break points) found by the last call is cached: so slowly changing 
+ * inputs skip the search entirely. Otherwise small curves use a linear search and larger 
+ * curves a binary search.
+ * 
+ * @note The cache makes map() non-const and not re-entrant: don't share a
+ * curve between an ISR and the main loop.
+ * 
+ * @tparam TAxis Axis (input) type
+ * @tparam TValue Value (output) type
+ * @tparam N Number of break points
+ */
+template <typename TAxis, typename TValue, uint16_t N>
+class fast_curve {
+    static_assert(N>=2U, "A curve needs at least 2 break points");
+
+    typedef fast_map_impl::bin_index_t<N> bin_t;
+
+public:
+    /**
+     * @brief Construct a new curve
+     * 
+     * @param axis Axis break points. Must be strictly increasing.
+     * @param values Value at each axis break point
+     */
+    fast_curve(const TAxis (&axis)[N], const TValue (&values)[N])
+        : _lastBin(0U)
+    {
+        for (uint16_t i=0; i<N; ++i) {
+            _axis[i] = axis[i];
+            _values[i] = values[i];
+        }
+    }
+
+    /**
+     * @brief Interpolate the curve value at an input.
+     * 
+     * @param in Input value
+     * @return TValue
+     */
+    TValue map(TAxis in) {
+        if (in<=_axis[0]) {
+            return _values[0];
+        }
+        if (in>=_axis[N-1U]) {
+            return _values[N-1U];
+        }
+        if (!inBin(in, _lastBin)) {
+            _lastBin = fast_map_impl::findBin(_axis, in);
+        }
+        return fast_map(in, _axis[_lastBin], _axis[_lastBin+1U], _values[_lastBin], _values[_lastBin+1U]);
+    }
+
+    /** @brief The axis break points: can be modified in place */
+    TAxis *axis(void) { return _axis; }
+    /** @brief The axis break points */
+    const TAxis *axis(void) const { return _axis; }
+    /** @brief The value at each break point: can be modified in place */
+    TValue *values(void) { return _values; }
+    /** @brief The value at each break point */
+    const TValue *values(void) const { return _values; }
+
+private:
+    bool inBin(const TAxis &in, bin_t bin) const {
+        return _axis[bin]<=in && in<=_axis[bin+1U];
+    }
+
+    TAxis _axis[N];
+    TValue _values[N];
+    bin_t _lastBin;
+};
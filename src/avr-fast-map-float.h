@@ -0,0 +1,194 @@
+#pragma once
+
+#include "avr-fast-map.h"
+#include <string.h>
+#if defined(__AVR__)
+#include <util/atomic.h>
+#endif
+
+/**
+ * @file
+ * @brief fast_map() for floating point arguments: float ranges, or a mix of float &
+ * integral inputs & outputs.
+ *
+ * The usual float formula, (in - inMin) * (outMax - outMin) / (inMax - inMin) + outMin,
+ * needs a division per call: on AVR that is the soft-float division, several hundred
+ * cycles. Instead, the range ratio (the scale) is computed separately:
+ *  * With constant ranges, the compiler computes the scale at compile time.
+ *  * fast_float_mapper computes the scale once, in the constructor: use it for
+ *    ranges set at run time.
+ *  * fast_map() with run time ranges: on AVR, the last ranges & scale are cached 
+ *    (per type combination), so only a change of ranges costs a division.
+ *
+ * Each map is then a multiply & an add, plus the subtraction of inMin (done in
+ * integer arithmetic for integral inputs).
+ *
+ * Accuracy, compared to the usual float formula:
+ *  * The scale is rounded to float before the multiply, so float results can differ
+ *    in the last bit. The error bound is the same: about 1 unit in the last place of
+ *    the larger of outMin & the output range.
+ *  * Integral outputs are truncated towards outMin, like fast_map(). Near an integral
+ *    result, the float rounding (of either formula) can land on the other side of the
+ *    integer, so the output can differ by 1 from the exact (integral fast_map())
+ *    result. Over random 16-bit ranges & in range inputs, about 1 in 2300 results 
+ *    differ (a similar rate to the usual float formula). The unit tests check that
+ *    fewer than 1 in 1000 differ.
+ *
+ * All calculations are in float, including for double arguments (on AVR, double is
+ * the same as float).
+ */
+
+/// @cond
+namespace fast_map_impl {
+
+    // A signed type that holds the difference of 2 values of type T
+    template <typename T>
+    using float_delta_t = typename type_traits::conditional<is_float<T>::value, float,
+                            typename type_traits::conditional<(sizeof(T)<sizeof(int32_t)), int32_t, int64_t>::type>::type;
+
+    // (in - inMin), as a float. For integral inputs, the subtraction is integral (cheaper
+    // than a float subtraction on AVR & exact)
+    template <typename TIn>
+    static inline float floatOffset(TIn in, TIn inMin) {
+        return (float)((float_delta_t<TIn>)in - (float_delta_t<TIn>)inMin);
+    }
+
+    // outMin + delta, converted to the output type. For integral outputs, delta is
+    // truncated towards zero (so the result is truncated towards outMin)
+    template <typename TOut>
+    static inline TOut addToOutMin(TOut outMin, float delta) {
+        return (TOut)((float_delta_t<TOut>)outMin + (float_delta_t<TOut>)delta);
+    }
+
+    template <typename TIn, typename TOut>
+    static inline constexpr float floatScale(TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+        return ((float)outMax - (float)outMin) / ((float)inMax - (float)inMin);
+    }
+
+    // Compare as bit patterns: so any change of a float range (including -0.0 or a
+    // NaN) recomputes the scale
+    template <typename T>
+    static inline bool sameBits(const T &a, const T &b) {
+        return memcmp(&a, &b, sizeof(T))==0;
+    }
+
+    template <typename TIn, typename TOut>
+    struct float_scale_cache {
+        TIn inMin;
+        TIn inMax;
+        TOut outMin;
+        TOut outMax;
+        float scale;
+        bool valid;
+    };
+
+    // floatScale(), for run time ranges: on AVR (soft-float division), the last ranges
+    // & their scale are cached. The cache is shared by all calls with the same types, 
+    // including from interrupt handlers: so it is copied with interrupts disabled, but
+    // the division isn't.
+    template <typename TIn, typename TOut>
+    static inline float cachedFloatScale(TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+#if defined(__AVR__)
+        typedef float_scale_cache<TIn, TOut> cache_t;
+        static cache_t cache;
+        cache_t cached;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            cached = cache;
+        }
+        if (cached.valid && sameBits(cached.inMin, inMin) && sameBits(cached.inMax, inMax)
+            && sameBits(cached.outMin, outMin) && sameBits(cached.outMax, outMax)) {
+            return cached.scale;
+        }
+        const cache_t updated = { inMin, inMax, outMin, outMax, floatScale(inMin, inMax, outMin, outMax), true };
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            cache = updated;
+        }
+        return updated.scale;
+#else
+        // Hardware (or fast) float division: caching would only add a shared state
+        return floatScale(inMin, inMax, outMin, outMax);
+#endif
+    }
+
+    template <typename TIn, typename TOut>
+    using float_map_t = typename enable_if<is_float<TIn>::value || is_float<TOut>::value, TOut>::type;
+}
+/// @endcond
+
+/**
+ * @brief fast_map() for floating point arguments.
+ *
+ * Either or both of the input & output types can be float, the other integral. E.g.
+ * @code
+ * float volts = fast_map(analogRead(A0), (uint16_t)0, (uint16_t)1023, 0.0F, 5.0F);
+ * @endcode
+ *
+ * With constant ranges, the call is a multiply & an add. For ranges set at run time,
+ * use fast_float_mapper: the scale is computed once, & map() is a multiply & an add.
+ * Otherwise a division is needed whenever the ranges change: on AVR the last ranges 
+ * & scale are cached, so repeated calls with the same ranges only compare them.
+ *
+ * See the file description for the accuracy.
+ *
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum (must not equal inMin)
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return TOut
+ */
+template <typename TIn, typename TOut>
+static inline fast_map_impl::float_map_t<TIn, TOut> fast_map(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    // Constant ranges: the scale is computed by the compiler
+    const float scale = (__builtin_constant_p(inMin) && __builtin_constant_p(inMax) 
+                         && __builtin_constant_p(outMin) && __builtin_constant_p(outMax))
+                        ? fast_map_impl::floatScale(inMin, inMax, outMin, outMax)
+                        : fast_map_impl::cachedFloatScale(inMin, inMax, outMin, outMax);
+    return fast_map_impl::addToOutMin(outMin, fast_map_impl::floatOffset(in, inMin) * scale);
+}
+
+/**
+ * @brief A pre-computed fast_map() for floating point arguments: the scale is computed
+ * once, in the constructor.
+ *
+ * Each map() call is then a multiply & an add, with no division. Results are identical
+ * to fast_map().
+ *
+ * @tparam TIn Input range type (float or integral)
+ * @tparam TOut Output range type (float or integral)
+ */
+template <typename TIn, typename TOut>
+class fast_float_mapper {
+public:
+    /**
+     * @brief Construct a new mapper object
+     *
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    fast_float_mapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax)
+        : _inMin(inMin)
+        , _outMin(outMin)
+        , _scale(fast_map_impl::floatScale(inMin, inMax, outMin, outMax))
+    {
+    }
+
+    /**
+     * @brief Map a value from the input range to the output range
+     *
+     * @param in Input value
+     * @return TOut
+     */
+    TOut map(TIn in) const {
+        return fast_map_impl::addToOutMin(_outMin, fast_map_impl::floatOffset(in, _inMin) * _scale);
+    }
+
+private:
+    TIn _inMin;
+    TOut _outMin;
+    float _scale;
+};
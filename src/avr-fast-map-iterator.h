@@ -0,0 +1,199 @@
+#pragma once
+
+#include "avr-fast-map.h"
+
+/**
+ * @file
+ * @brief Map an input that changes by a constant step each time (E.g. ramps, fades,
+ * axis generation) without a division per step.
+ */
+
+/// @cond
+namespace fast_map_impl {
+
+    // The scaled distance of an input from inMin, updated incrementally (DDA/Bresenham
+    // style) as the input moves by a fixed step. Invariant:
+    //   position * outRange == quotient * inRange + remainder
+    //
+    // The quotient is modulo the output type, same as fast_map()
+    template <typename TIn, typename TOut>
+    class scaled_position {
+        typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+        typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+    public:
+        scaled_position(in_unsigned_t inRange, out_unsigned_t outRange, in_unsigned_t step)
+            : _inRange(inRange)
+            , _outRange(outRange)
+            , _step(step)
+            , _position(0U)
+            , _quotient(0U)
+            , _remainder(0U)
+            , _opposite(false)
+        {
+            divMod(_step, _stepQuotient, _stepRemainder);
+        }
+
+        // Jump to a new position: a full fast_map() calculation
+        void seek(in_unsigned_t position, bool opposite) {
+            _position = position;
+            _opposite = opposite;
+            divMod(_position, _quotient, _remainder);
+        }
+
+        // Move one step, without a division
+        void step(bool towardsInMax) {
+            // The position (distance from inMin) grows when stepping towards inMax on the
+            // same side of inMin, or away from inMax on the opposite side
+            if (_opposite!=towardsInMax) {
+                moveAway();
+            } else if (_step<=_position) {
+                moveTowards();
+            } else {
+                crossInMin();
+            }
+        }
+
+        // The mapped value: identical to fast_map() at the current position
+        TOut value(const TOut &outMin, bool outRangeInverted) const {
+            if (_opposite!=outRangeInverted) {
+                return (TOut)(outMin - _quotient);
+            }
+            return (TOut)(outMin + _quotient);
+        }
+
+    private:
+        void divMod(in_unsigned_t m, out_unsigned_t &quotient, in_unsigned_t &remainder) const {
+            const auto fullQuotient = mulDiv(m, _outRange, _inRange);
+            typedef decltype(safeMultiply(m, _outRange)) product_t;
+            quotient = (out_unsigned_t)fullQuotient;
+            remainder = (in_unsigned_t)(safeMultiply(m, _outRange) - (product_t)(fullQuotient * _inRange));
+        }
+
+        // position += step
+        void moveAway(void) {
+            _position = (in_unsigned_t)(_position + _step);
+            _quotient = (out_unsigned_t)(_quotient + _stepQuotient);
+            if (_remainder>=(in_unsigned_t)(_inRange-_stepRemainder)) {
+                _remainder = (in_unsigned_t)(_remainder - (in_unsigned_t)(_inRange-_stepRemainder));
+                ++_quotient;
+            } else {
+                _remainder = (in_unsigned_t)(_remainder + _stepRemainder);
+            }
+        }
+
+        // position -= step, where step<=position
+        void moveTowards(void) {
+            _position = (in_unsigned_t)(_position - _step);
+            _quotient = (out_unsigned_t)(_quotient - _stepQuotient);
+            if (_remainder<_stepRemainder) {
+                _remainder = (in_unsigned_t)(_remainder + (in_unsigned_t)(_inRange-_stepRemainder));
+                --_quotient;
+            } else {
+                _remainder = (in_unsigned_t)(_remainder - _stepRemainder);
+            }
+        }
+
+        // The step crosses inMin: the new position is step-position, on the other side
+        void crossInMin(void) {
+            _position = (in_unsigned_t)(_step - _position);
+            _quotient = (out_unsigned_t)(_stepQuotient - _quotient);
+            if (_remainder<=_stepRemainder) {
+                _remainder = (in_unsigned_t)(_stepRemainder - _remainder);
+            } else {
+                _remainder = (in_unsigned_t)(_inRange - (in_unsigned_t)(_remainder - _stepRemainder));
+                --_quotient;
+            }
+            _opposite = !_opposite;
+        }
+
+        in_unsigned_t _inRange;
+        out_unsigned_t _outRange;
+        in_unsigned_t _step;
+        in_unsigned_t _position;
+        out_unsigned_t _quotient;
+        in_unsigned_t _remainder;
+        // step * outRange == _stepQuotient * _inRange + _stepRemainder
+        out_unsigned_t _stepQuotient;
+        in_unsigned_t _stepRemainder;
+        // The position is on the opposite side of inMin to inMax
+        bool _opposite;
+    };
+}
+/// @endcond
+
+/**
+ * @brief Maps a sequence of inputs, start, start+step, start+2*step, ...
+ *
+ * An incremental (DDA/Bresenham style) version of fast_map(): the quotient &
+ * remainder of the scaling are carried from one step to the next. The divisions
+ * are done once, in the constructor: each step then costs a few additions &
+ * comparisons.
+ *
+ * The step can be any size & either sign, the ranges can be inverted and the
+ * sequence can go outside the input range (including crossing inMin). Every
+ * value() is identical to fast_map() for the current input().
+ *
+ * @note The sequence must not overflow the input type.
+ *
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <typename TIn, typename TOut>
+class fast_map_iterator {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+
+public:
+    /** @brief Step type: a signed type wide enough for any step across the input type */
+    typedef fast_map_impl::widen_integral_t<fast_map_impl::make_signed_t<in_unsigned_t>> step_t;
+
+    /**
+     * @brief Construct a new iterator
+     *
+     * @param start First input
+     * @param step Change in the input for each call to next()
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    fast_map_iterator(TIn start, step_t step, TIn inMin, TIn inMax, TOut outMin, TOut outMax)
+        : _position(fast_map_impl::absDelta(inMin, inMax), fast_map_impl::absDelta(outMin, outMax), (in_unsigned_t)(step<0 ? -step : step))
+        , _input(start)
+        , _step((in_unsigned_t)(step<0 ? -step : step))
+        , _outMin(outMin)
+        , _outRangeInverted(outMax<outMin)
+        , _stepIncreasesInput(step>=0)
+        , _stepTowardsInMax((step>=0)==(inMin<=inMax))
+    {
+        _position.seek(fast_map_impl::absDelta(inMin, start), (start<inMin)!=(inMax<inMin));
+    }
+
+    /** @brief The current input */
+    TIn input(void) const { return _input; }
+
+    /** @brief The current output: identical to fast_map(input(), inMin, inMax, outMin, outMax) */
+    TOut value(void) const {
+        return _position.value(_outMin, _outRangeInverted);
+    }
+
+    /**
+     * @brief Advance to the next input
+     *
+     * @return The output for the next input (same as value())
+     */
+    TOut next(void) {
+        _input = _stepIncreasesInput ? (TIn)(_input + _step) : (TIn)(_input - _step);
+        _position.step(_stepTowardsInMax);
+        return value();
+    }
+
+private:
+    fast_map_impl::scaled_position<TIn, TOut> _position;
+    TIn _input;
+    in_unsigned_t _step;
+    TOut _outMin;
+    bool _outRangeInverted;
+    bool _stepIncreasesInput;
+    bool _stepTowardsInMax;
+};
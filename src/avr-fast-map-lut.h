@@ -0,0 +1,109 @@
+#pragma once
+
+#include "avr-fast-map.h"
+
+/**
+ * @file
+ * @brief Lookup table versions of fast_map(), for 8-bit inputs.
+ * 
+ * For uint8_t inputs there are at most 256 possible results, so the results can
+ * be computed at compile time & stored in a table. Each map operation is then 
+ * a single table read.
+ * 
+ * On AVR, the table is stored in flash (PROGMEM).
+ */
+
+/// @cond
+namespace fast_map_impl {
+
+    // Read a table entry (from flash on AVR)
+    template <typename T, uint8_t size = sizeof(T)> struct lut_reader { };
+    template <typename T> struct lut_reader<T, 1U> {
+        static inline T read(const T *pEntry) {
+#if defined(__AVR__)
+            return (T)pgm_read_byte(pEntry);
+#else
+            return *pEntry;
+#endif
+        }
+    };
+    template <typename T> struct lut_reader<T, 2U> {
+        static inline T read(const T *pEntry) {
+#if defined(__AVR__)
+            return (T)pgm_read_word(pEntry);
+#else
+            return *pEntry;
+#endif
+        }
+    };
+    template <typename T> struct lut_reader<T, 4U> {
+        static inline T read(const T *pEntry) {
+#if defined(__AVR__)
+            return (T)pgm_read_dword(pEntry);
+#else
+            return *pEntry;
+#endif
+        }
+    };
+
+    template <typename TOut, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax, uint8_t first, typename TIndexes>
+    struct lut_storage;
+
+    template <typename TOut, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax, uint8_t first, size_t... Idx>
+    struct lut_storage<TOut, inMin, inMax, outMin, outMax, first, type_traits::index_sequence<Idx...>> {
+        static const TOut table[sizeof...(Idx)];
+    };
+
+    // The table itself: generated at compile time, one entry per input
+    template <typename TOut, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax, uint8_t first, size_t... Idx>
+    const TOut lut_storage<TOut, inMin, inMax, outMin, outMax, first, type_traits::index_sequence<Idx...>>::table[sizeof...(Idx)] FAST_MAP_PROGMEM = {
+        constMap<TOut>((int32_t)(first+Idx), inMin, inMax, outMin, outMax)...
+    };
+}
+/// @endcond
+
+/**
+ * @brief A lookup table version of fast_map<inMin, inMax, outMin, outMax>(in), for uint8_t inputs.
+ * 
+ * The table is generated at compile time & each map() call is a single table read. 
+ * 
+ * By default the table covers all 256 inputs (256*sizeof(TOut) bytes). In compact mode,
+ * only inputs in [first, last] are stored in the table: inputs outside that span 
+ * fall back to fast_map().
+ * 
+ * E.g. @code fast_map_lut<0, 255, 0, 100>::map(in) @endcode
+ * 
+ * Results are identical to fast_map() (and therefore Arduino's map()).
+ * 
+ * @tparam inMin Input range minimum
+ * @tparam inMax Input range maximum
+ * @tparam outMin Output range minimum
+ * @tparam outMax Output range maximum
+ * @tparam TOut Output range type. Defaults to the narrowest type that can hold the output range.
+ * @tparam first First input stored in the table
+ * @tparam last Last input stored in the table
+ */
+template <int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax,
+          typename TOut = fast_map_impl::narrowest_integral_t<outMin, outMax>,
+          uint8_t first = 0U, uint8_t last = UINT8_MAX>
+struct fast_map_lut {
+    static_assert(first<=last, "Table span cannot be empty");
+    static_assert(sizeof(TOut)<=sizeof(uint32_t), "Output type must be 32-bit or narrower");
+
+    typedef fast_map_impl::lut_storage<TOut, inMin, inMax, outMin, outMax, first, 
+                                       type_traits::make_index_sequence<(size_t)last-first+1U>> storage_t;
+
+    /**
+     * @brief Map a value from the input range to the output range
+     * 
+     * @param in Input value
+     * @return TOut 
+     */
+    static inline TOut map(uint8_t in) {
+        // Single unsigned comparison, since in-first will wrap if in<first
+        if ((uint8_t)(in-first)<=(uint8_t)(last-first)) {
+            return fast_map_impl::lut_reader<TOut>::read(&storage_t::table[(uint8_t)(in-first)]);
+        }
+        return fast_map<inMin, inMax, outMin, outMax, TOut>(in);
+    }
+};
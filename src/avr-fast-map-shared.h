@@ -0,0 +1,99 @@
+#pragma once
+
+#include "avr-fast-map.h"
+
+/**
+ * @file
+ * @brief A mapper whose ranges can be changed while interrupt handlers are using it.
+ */
+
+/**
+ * @brief A fast_mapper that can be shared between interrupt handlers & the main loop,
+ * with ranges that can be updated at run time (E.g. calibration from a tuning PC).
+ *
+ * On an 8-bit CPU, updating multi-byte ranges isn't atomic: an interrupt part way
+ * through an update would see a mix of old & new values. Instead of disabling
+ * interrupts around every call, this keeps 2 copies (slots) of the pre-computed
+ * mapper plus a sequence number:
+ *  * The writer builds the new mapper in the inactive slot, then publishes it by
+ *    incrementing the sequence number (a single byte store, so atomic).
+ *  * Readers map with the slot selected by the sequence number, then re-check it:
+ *    if it changed, the slot may have been overwritten during the call, so the
+ *    call is repeated (a sequence lock).
+ *
+ * Readers never see a partially updated set of ranges, and neither readers nor the
+ * writer disable interrupts. A reader in an interrupt handler never repeats a call,
+ * since the writer can't run until it returns.
+ *
+ * @note There must be a single writer: calls to set_ranges() must not interrupt
+ * each other.
+ *
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <typename TIn, typename TOut>
+class fast_shared_mapper {
+public:
+    /**
+     * @brief Construct a new mapper object
+     *
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    fast_shared_mapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax)
+        : _slots{ fast_mapper<TIn, TOut>(inMin, inMax, outMin, outMax), fast_mapper<TIn, TOut>(inMin, inMax, outMin, outMax) }
+        , _sequence(0U)
+    {
+    }
+
+    /**
+     * @brief Map a value, using the most recently published ranges.
+     *
+     * Safe to call from interrupt handlers & the main loop.
+     *
+     * @param in Input value
+     * @return TOut
+     */
+    TOut map(TIn in) const {
+        uint8_t sequence;
+        TOut result;
+        do {
+            sequence = _sequence;
+            barrier();
+            result = _slots[sequence & 1U].map(in);
+            barrier();
+        } while (sequence!=_sequence);
+        return result;
+    }
+
+    /**
+     * @brief Publish a new set of ranges: subsequent map() calls use all of the new
+     * ranges, never a mix of old & new.
+     *
+     * Does the same pre-computation as the fast_mapper constructor (so it is slower
+     * than a map() call).
+     *
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    void set_ranges(TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+        const uint8_t next = (uint8_t)(_sequence + 1U);
+        _slots[next & 1U] = fast_mapper<TIn, TOut>(inMin, inMax, outMin, outMax);
+        barrier();
+        _sequence = next;
+    }
+
+private:
+    // Stop the compiler moving slot accesses across the sequence number accesses.
+    // Interrupt handlers run on the same core, so no hardware fence is needed.
+    static inline void barrier(void) {
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+    }
+
+    fast_mapper<TIn, TOut> _slots[2];
+    volatile uint8_t _sequence;
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "avr-fast-map-curve.h"
+
+/**
+ * @file
+ * @brief Bilinear interpolation over a 2D table (E.g. fuel or ignition tables).
+ */
+
+/// @cond
+namespace fast_map_impl {
+
+    // The position of an input on a table axis: the bin & how far across the bin the 
+    // input is (the weight). 
+    //
+    // The weight is a 0.16 fixed point fraction. So we can always represent the weight,
+    // bins are half open: axis[bin]<=in<axis[bin+1]. Inputs at or beyond the last break
+    // point are placed in the last bin (N-1) with zero weight.
+    //
+    // The weight is a division by the bin width: like fast_mapper, the division is 
+    // replaced with a cached fixed point reciprocal of the width, computed when the
+    // input enters a new bin. Moving within a bin is then multiplies only.
+    template <typename TAxis, uint16_t N>
+    class axis_position {
+        static_assert(sizeof(TAxis)<=sizeof(uint16_t), "Axis type must be 16-bit or narrower");
+        typedef bin_index_t<N> bin_t;
+        typedef fast_map_impl::make_unsigned_t<TAxis> axis_unsigned_t;
+
+    public:
+        axis_position(void) 
+            : _lastIn(0), _bin(0U), _weight(0U), _valid(false)
+            , _cellBin((bin_t)N), _quotient(0U), _recip(0U)
+        {
+        }
+
+        // Locate the input on the axis. Returns false if the input is unchanged (so 
+        // the position is too).
+        bool update(const TAxis (&axis)[N], const TAxis &in) {
+            // Early return: same input as the last call
+            if (_valid && in==_lastIn) {
+                return false;
+            }
+            _lastIn = in;
+            _valid = true;
+            if (in<=axis[0]) {
+                _bin = 0U;
+                _weight = 0U;
+            } else if (in>=axis[N-1U]) {
+                _bin = (bin_t)(N-1U);
+                _weight = 0U;
+            } else {
+                // Only search if the input has left the cached bin
+                if (_bin>=N-1U || in<axis[_bin] || in>=axis[_bin+1U]) {
+                    _bin = findBin(axis, in);
+                }
+                if (_cellBin!=_bin) {
+                    cacheCell(axis[_bin], axis[_bin+1U]);
+                    _cellBin = _bin;
+                }
+                _weight = cellWeight(absDelta(axis[_bin], in));
+            }
+            return true;
+        }
+
+        void invalidate(void) { 
+            _valid = false; 
+            _cellBin = (bin_t)N;
+        }
+
+        bin_t bin(void) const { return _bin; }
+        uint16_t weight(void) const { return _weight; }
+
+    private:
+        // 65536 == (_quotient * width) + remainder
+        void cacheCell(const TAxis &min, const TAxis &max) {
+            const axis_unsigned_t width = absDelta(min, max);
+            // A width of 1 truncates the quotient to 0: harmless, since the only offset
+            // within the bin is 0
+            _quotient = (uint16_t)(65536UL / width);
+            _recip = fixedPointReciprocal((axis_unsigned_t)(65536UL % width), width);
+        }
+
+        // (offset << 16) / width, where offset<width. Exact: see scaleByReciprocal()
+        uint16_t cellWeight(const axis_unsigned_t &offset) const {
+            // Cannot overflow: offset * _quotient <= (offset << 16) / width < 65536
+            return (uint16_t)((uint16_t)((uint16_t)offset * _quotient) + multiplyHigh(offset, _recip));
+        }
+
+        TAxis _lastIn;
+        bin_t _bin;
+        uint16_t _weight;
+        bool _valid;
+        // The bin the reciprocal is for (N if none)
+        bin_t _cellBin;
+        uint16_t _quotient;
+        widen_integral_t<axis_unsigned_t> _recip;
+    };
+
+    // v0 + ((v1-v0) * weight), where weight is a 0.16 fixed point fraction.
+    //
+    // Like fast_map(), this uses unsigned types to avoid overflow and adjusts for direction.
+    template <typename TValue>
+    static inline TValue weightedInterpolate(const TValue &v0, const TValue &v1, const uint16_t &weight) {
+        typedef fast_map_impl::make_unsigned_t<TValue> value_unsigned_t;
+        const value_unsigned_t scaled = (value_unsigned_t)(safeMultiply(absDelta(v0, v1), weight) >> 16U);
+        if (v1<v0) {
+            return (TValue)(v0 - scaled);
+        }
+        return (TValue)(v0 + scaled);
+    }
+}
+/// @endcond
+
+/**
+ * @brief A 2D table, with bilinear interpolation between cells.
+ * 
+ * Each lookup locates the input on both axes once, as a bin & a fixed point weight. 
+ * The weights are then shared by the 3 interpolations (2 along the X axis, 1 along the Y axis), 
+ * which need a multiply but no division.
+ * 
+ * The position on each axis is cached: if an input hasn't changed there's no work to
+ * do for that axis, if it has changed but remains in the same cell there's no search
+ * & no division (the cell width's reciprocal is cached too). If neither input has 
+ * changed, the last result is returned.
+ * 
+ * Inputs outside the axis ranges are clamped to the table edges.
+ * 
+ * @note Since the weights are fixed point, each interpolation can be 1 less (in magnitude)
+ * than the equivalent fast_map() call. Inputs on a break point return the table value exactly.
+ * 
+ * @note The cache makes map() non-const and not re-entrant: don't share a
+ * table between an ISR and the main loop.
+ * 
+ * @tparam TAxisX X axis (input) type. 16-bit or narrower.
+ * @tparam TAxisY Y axis (input) type. 16-bit or narrower.
+ * @tparam TValue Value (output) type
+ * @tparam NX Number of X axis break points
+ * @tparam NY Number of Y axis break points
+ */
+template <typename TAxisX, typename TAxisY, typename TValue, uint16_t NX, uint16_t NY>
+class fast_table2d {
+    static_assert(NX>=2U && NY>=2U, "A table needs at least 2 break points per axis");
+
+public:
+    /**
+     * @brief Construct a new table
+     * 
+     * @param xAxis X axis break points. Must be strictly increasing.
+     * @param yAxis Y axis break points. Must be strictly increasing.
+     * @param values Cell values, indexed as [y][x]
+     */
+    fast_table2d(const TAxisX (&xAxis)[NX], const TAxisY (&yAxis)[NY], const TValue (&values)[NY][NX]) {
+        for (uint16_t x=0; x<NX; ++x) {
+            _xAxis[x] = xAxis[x];
+        }
+        for (uint16_t y=0; y<NY; ++y) {
+            _yAxis[y] = yAxis[y];
+            for (uint16_t x=0; x<NX; ++x) {
+                _values[y][x] = values[y][x];
+            }
+        }
+    }
+
+    /**
+     * @brief Interpolate the table value at an (x, y) input.
+     * 
+     * @param x X axis input
+     * @param y Y axis input
+     * @return TValue
+     */
+    TValue map(TAxisX x, TAxisY y) {
+        const bool xChanged = _x.update(_xAxis, x);
+        const bool yChanged = _y.update(_yAxis, y);
+        if (_resultValid && !xChanged && !yChanged) {
+            return _lastResult;
+        }
+        _lastResult = interpolate();
+        _resultValid = true;
+        return _lastResult;
+    }
+
+    /** @brief The X axis break points: can be modified in place (invalidates the cache) */
+    TAxisX *xAxis(void) { _x.invalidate(); return _xAxis; }
+    /** @brief The X axis break points */
+    const TAxisX *xAxis(void) const { return _xAxis; }
+    /** @brief The Y axis break points: can be modified in place (invalidates the cache) */
+    TAxisY *yAxis(void) { _y.invalidate(); return _yAxis; }
+    /** @brief The Y axis break points */
+    const TAxisY *yAxis(void) const { return _yAxis; }
+    /** @brief A row of cell values (for one Y axis break point): can be modified in place (invalidates the cache) */
+    TValue *row(uint16_t y) { _resultValid = false; return _values[y]; }
+    /** @brief A row of cell values (for one Y axis break point) */
+    const TValue *row(uint16_t y) const { return _values[y]; }
+
+private:
+    TValue interpolate(void) const {
+        // A zero weight means we must not read the next bin: it may not exist.
+        const TValue lower = interpolateRow(_values[_y.bin()]);
+        if (_y.weight()==0U) {
+            return lower;
+        }
+        const TValue upper = interpolateRow(_values[_y.bin()+1U]);
+        return fast_map_impl::weightedInterpolate(lower, upper, _y.weight());
+    }
+
+    TValue interpolateRow(const TValue (&row)[NX]) const {
+        if (_x.weight()==0U) {
+            return row[_x.bin()];
+        }
+        return fast_map_impl::weightedInterpolate(row[_x.bin()], row[_x.bin()+1U], _x.weight());
+    }
+
+    TAxisX _xAxis[NX];
+    TAxisY _yAxis[NY];
+    TValue _values[NY][NX];
+    fast_map_impl::axis_position<TAxisX, NX> _x;
+    fast_map_impl::axis_position<TAxisY, NY> _y;
+    TValue _lastResult = 0;
+    bool _resultValid = false;
+};
@@ -1,10 +1,37 @@
 #pragma once
 
+#include <stdint.h>
 #include <avr-fast-div.h>
-
-#if defined(USE_OPTIMIZED_DIV)
 #include <type_traits.h>
 
+// avr-gcc has native 24-bit integral types (__uint24 & __int24)
+#if defined(__UINT24_MAX__)
+#define FAST_MAP_INT24
+#endif
+
+// Optional inline assembly kernels for the 8-bit & mixed 8/16-bit cases: define
+// FAST_MAP_AVR_ASM to use them. Off by default until they have been verified &
+// measured in the simulator (see the megaatmega2560-O3-asm-sim environment). They
+// need the MUL instruction (not available on ATtiny): ignored otherwise.
+#if defined(FAST_MAP_AVR_ASM) && !(defined(USE_OPTIMIZED_DIV) && defined(__AVR_HAVE_MUL__) && defined(FAST_MAP_INT24))
+#undef FAST_MAP_AVR_ASM
+#endif
+
+// Tables are stored in flash on AVR
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define FAST_MAP_PROGMEM PROGMEM
+#else
+#define FAST_MAP_PROGMEM
+#endif
+
+// Optional table of reciprocals, to replace the division for small input ranges.
+// Define as the largest input range to cover, E.g. -DFAST_MAP_RECIPROCAL_LUT=1023.
+// Each entry is 2 bytes of flash: so 512 bytes for 255, 2KB for 1023.
+#if defined(FAST_MAP_RECIPROCAL_LUT) && (FAST_MAP_RECIPROCAL_LUT<1 || FAST_MAP_RECIPROCAL_LUT>1023)
+#error "FAST_MAP_RECIPROCAL_LUT must be between 1 and 1023"
+#endif
+
 /**
  * @file
  * @brief A faster implementation of the Arduino map() function.
@@ -13,6 +40,9 @@
  * automatic promotion to long (int32_t) (assuming the caller is using the smallest 
  * integral types possible)
  *
+ * Other platforms use the same implementation, with native division. There is no
+ * dependency on Arduino.h, so the library can also be built & tested on a workstation.
+ *
  */
 
 /// @cond
@@ -53,11 +83,50 @@ namespace type_traits {
 
   template<typename _Tp>
     using make_signed_t = typename make_signed<_Tp>::type;
+
+  // Limited replacement for std::index_sequence & std::make_index_sequence
+  template<size_t... _Idx>
+    struct index_sequence { };
+
+  template<typename _Seq1, typename _Seq2>
+    struct concat_index_sequence;
+
+  template<size_t... _Idx1, size_t... _Idx2>
+    struct concat_index_sequence<index_sequence<_Idx1...>, index_sequence<_Idx2...>>
+    { typedef index_sequence<_Idx1..., (sizeof...(_Idx1)+_Idx2)...> type; };
+
+  // Split in half at each step, so the recursion depth is log2(_Num)
+  template<size_t _Num>
+    struct make_index_sequence_helper
+    { typedef typename concat_index_sequence<typename make_index_sequence_helper<_Num/2U>::type,
+                                             typename make_index_sequence_helper<_Num-(_Num/2U)>::type>::type type; };
+
+  template<>
+    struct make_index_sequence_helper<0U> { typedef index_sequence<> type; };
+
+  template<>
+    struct make_index_sequence_helper<1U> { typedef index_sequence<0U> type; };
+
+  template<size_t _Num>
+    using make_index_sequence = typename make_index_sequence_helper<_Num>::type;
 }
 
 // 
 namespace fast_map_impl {
 
+    // type_traits::make_unsigned & make_signed, plus avr-gcc's 24-bit types. These
+    // are kept out of the type_traits namespace: it belongs to avr-fast-div.
+    template <typename T> struct make_unsigned { typedef typename type_traits::make_unsigned<T>::type type; };
+    template <typename T> struct make_signed { typedef typename type_traits::make_signed<T>::type type; };
+#if defined(FAST_MAP_INT24)
+    template <> struct make_unsigned<__int24> { typedef __uint24 type; };
+    template <> struct make_signed<__uint24> { typedef __int24 type; };
+#endif
+    template <typename T>
+    using make_unsigned_t = typename make_unsigned<T>::type;
+    template <typename T>
+    using make_signed_t = typename make_signed<T>::type;
+
     // Widen an integral type to the next larger type.
     // This is used to avoid overflow during the calculation.
     template < typename T > struct widen_integral { } ;
@@ -79,37 +148,684 @@ namespace fast_map_impl {
     template< > struct widen_integral<int32_t> {
         typedef int64_t type;
     };    
+#if defined(FAST_MAP_INT24)
+    template< > struct widen_integral<__uint24> {
+        typedef uint64_t type;
+    };
+    template< > struct widen_integral<__int24> {
+        typedef int64_t type;
+    };
+#endif
     template< typename T >
     using widen_integral_t = typename widen_integral<T>::type;
+
+#if defined(FAST_MAP_INT24)
+    typedef __uint24 uint_least24_t;
+#else
+    typedef uint32_t uint_least24_t;
+#endif
+
+    // The narrowest unsigned type with at least the given number of bits
+    template <uint8_t bits>
+    struct uint_least_bits {
+        static_assert(bits<=64U, "No integral type is wide enough");
+        typedef typename type_traits::conditional<(bits<=8U), uint8_t,
+                    typename type_traits::conditional<(bits<=16U), uint16_t,
+                        typename type_traits::conditional<(bits<=24U), uint_least24_t,
+                            typename type_traits::conditional<(bits<=32U), uint32_t, uint64_t>::type>::type>::type>::type type;
+    };
+    template <uint8_t bits>
+    using uint_least_bits_t = typename uint_least_bits<bits>::type;
+
+    // The narrowest integral type with at least the given number of bytes. There is 
+    // nothing wider than 64-bits: so products of 64-bit operands (E.g. long on 64-bit 
+    // hosts) are 64-bit, and can overflow like Arduino's map().
+    template <uint8_t bytes, bool isSigned>
+    using integral_least_bytes_t = typename type_traits::conditional<isSigned, 
+                                        fast_map_impl::make_signed_t<uint_least_bits_t<(bytes<8U ? bytes : 8U)*8U>>, 
+                                        uint_least_bits_t<(bytes<8U ? bytes : 8U)*8U>>::type;
  
+    // Limited replacements for std::is_floating_point & std::enable_if. The integral
+    // fast_map() overload is only enabled if neither argument type is floating point:
+    // see avr-fast-map-float.h for the floating point overload.
+    template <typename T> struct is_float { static constexpr bool value = false; };
+    template <> struct is_float<float> { static constexpr bool value = true; };
+    template <> struct is_float<double> { static constexpr bool value = true; };
+    template <bool _Cond, typename T> struct enable_if { };
+    template <typename T> struct enable_if<true, T> { typedef T type; };
+
+    template <typename TIn, typename TOut>
+    using integral_map_t = typename enable_if<!is_float<TIn>::value && !is_float<TOut>::value, TOut>::type;
+
     // Get the absolute difference between two values.
     // This is used to handle negative ranges.
     // Equivalent of abs(min-max)
     template <typename T>
-    static inline type_traits::make_unsigned_t<T> absDelta(const T &min, const T &max) {
+    static inline fast_map_impl::make_unsigned_t<T> absDelta(const T &min, const T &max) {
+        // Subtract as unsigned: the signed difference can overflow (undefined behavior)
+        typedef fast_map_impl::make_unsigned_t<T> unsigned_t;
         if (max<min) {
-            return (T)(min - max);
+            return (unsigned_t)((unsigned_t)min - (unsigned_t)max);
         }
-        return (T)(max - min);
+        return (unsigned_t)((unsigned_t)max - (unsigned_t)min);
     }
 
     template <typename T, typename U, 
               // Note that std::common_type will not do what we want here, as it will use integer
               // calculation promotion rules. So everything will be "int" at a minimum - our
               // goal is to use the narrowest type possible for performance reasons.
-              typename TCommon = typename type_traits::conditional<(sizeof(T) >= sizeof(U)), T, U>::type,
-              // Widen the common type - this is our intermediate calculation type
-              // to avoid overflow.
-              typename TResult = typename fast_map_impl::widen_integral_t<TCommon>>
+              //
+              // The product of an n byte & an m byte value fits in n+m bytes. E.g. 16x8 
+              // products are 24-bit on AVR (32-bit elsewhere).
+              typename TResult = integral_least_bytes_t<sizeof(T)+sizeof(U), type_traits::is_signed<T>::value>>
     TResult safeMultiply(const T &a, const U &b) {
         static_assert(type_traits::is_signed<T>::value==type_traits::is_signed<U>::value, "Both types must be signed or unsigned");
         return (TResult)(static_cast<TResult>(a) * static_cast<TResult>(b));
     }
 
+    // Portable division: CPUs with a hardware divider (E.g. Cortex-M3+, x86)
+    // divide natively. CPUs without one (E.g. Cortex-M0/M0+) call the compiler's
+    // library routine: a reciprocal would cost a division to compute, so only the
+    // mappers (which compute it once) & the reciprocal table avoid it.
+    template <typename T, typename U>
+    static inline T nativeDivide(const T &dividend, const U &divisor) {
+        return (T)(dividend / divisor);
+    }
+
+    // A 64-bit division is a library call on 32-bit CPUs, so use a 32-bit 
+    // division whenever the values fit. They usually do: E.g. a 32-bit 
+    // intermediate product is only needed for ranges that are wider than 16-bits
+    template <typename U>
+    static inline uint64_t nativeDivide(const uint64_t &dividend, const U &divisor) {
+        if (dividend<=UINT32_MAX && divisor<=UINT32_MAX) {
+            return (uint32_t)dividend / (uint32_t)divisor;
+        }
+        return dividend / divisor;
+    }
+
+    template <typename T> struct is_int24 { static constexpr bool value = false; };
+#if defined(FAST_MAP_INT24)
+    template <> struct is_int24<__uint24> { static constexpr bool value = true; };
+    template <> struct is_int24<__int24> { static constexpr bool value = true; };
+#endif
+
+    template <bool native> struct native_division_tag { };
+
+    template <typename T, typename U>
+    static inline T divide(const T &dividend, const U &divisor, native_division_tag<true>) {
+        return nativeDivide(dividend, divisor);
+    }
+
+#if defined(USE_OPTIMIZED_DIV)
+    template <typename T, typename U>
+    static inline T divide(const T &dividend, const U &divisor, native_division_tag<false>) {
+        return (T)fast_div(dividend, divisor);
+    }
+#endif
+
+    // Use the optimized division functions, if available. 
+    //
+    // avr-fast-div doesn't support 24-bit types: but avr-gcc's native 24-bit
+    // division is faster than promoting to 32-bits anyway.
+    template <typename T, typename U>
+    static inline T divide(const T &dividend, const U &divisor) {
+#if defined(USE_OPTIMIZED_DIV)
+        return divide(dividend, divisor, native_division_tag<is_int24<T>::value || is_int24<U>::value>());
+#else
+        return divide(dividend, divisor, native_division_tag<true>());
+#endif
+    }
+
+    // Selects the mulDiv() & constantTimeMulDiv() implementations, from the width 
+    // (in bytes) of the full product
+    template <uint8_t productBytes> struct product_width_tag { };
+
+    template <typename TA, typename TB, typename TDivisor, uint8_t productBytes>
+    static inline auto mulDiv(const TA &a, const TB &b, const TDivisor &divisor, product_width_tag<productBytes>) 
+        -> decltype(safeMultiply(a, b)) {
+        return divide(safeMultiply(a, b), divisor);
+    }
+
+    // 16-bit operands: the product type is 32-bit. But the actual values are often
+    // much smaller than the types allow (E.g. a 10-bit ADC reading), so check the 
+    // widths at run time & use a 16-bit product & division if possible.
+    static inline uint32_t mulDiv16(uint16_t a, uint16_t b, const uint16_t &divisor) {
+        if (a<b) {
+            const uint16_t swap = a;
+            a = b;
+            b = swap;
+        }
+        if (b<=UINT8_MAX) {
+            // 16x8 multiply, from 2 8x8=>16 multiplies: 
+            //  product == (high << 8) + low, which is at most 24 bits
+            const uint16_t low = (uint16_t)((uint8_t)a * (uint8_t)b);
+            const uint16_t high = (uint16_t)((uint8_t)(a >> 8U) * (uint8_t)b);
+            const uint16_t product = (uint16_t)((uint16_t)(high << 8U) + low);
+            if (high<=UINT8_MAX && product>=low) {
+                // Product fits in 16 bits
+                return divide(product, divisor);
+            }
+#if defined(FAST_MAP_INT24)
+            // Product fits in 24 bits
+            return divide((__uint24)((__uint24)((__uint24)high << 8U) + low), divisor);
+#endif
+        }
+        return divide((uint32_t)((uint32_t)a * b), divisor);
+    }
+
+    template <typename TA, typename TB, typename TDivisor>
+    static inline uint32_t mulDiv(const TA &a, const TB &b, const TDivisor &divisor, product_width_tag<sizeof(uint32_t)>) {
+        return mulDiv16(a, b, divisor);
+    }
+
+    // 32-bit operands: the product is 64-bit, and a 64-bit multiply & divide is
+    // *very* slow on AVR (slower than map()). But the actual values are usually
+    // much smaller than the types allow, so check the widths at run time & only 
+    // use 64-bit arithmetic when the product really needs it.
+    static inline uint32_t mulDiv32(uint32_t a, uint32_t b, const uint32_t &divisor) {
+        if (a<b) {
+            const uint32_t swap = a;
+            a = b;
+            b = swap;
+        }
+        if (b<=UINT16_MAX) {
+            // 32x16 multiply, from 2 16x16=>32 multiplies: 
+            //  product == (high << 16) + low, which is at most 48 bits
+            const uint32_t low = (uint32_t)(uint16_t)a * (uint16_t)b;
+            const uint32_t high = (uint32_t)(uint16_t)(a >> 16U) * (uint16_t)b;
+            const uint32_t product = (uint32_t)(high << 16U) + low;
+            if (high<=UINT16_MAX && product>=low) {
+                // Product fits in 32 bits
+                return divide(product, divisor);
+            }
+            if (divisor<=UINT16_MAX) {
+                // 48/16 division, from 2 32/16 divisions (schoolbook long division 
+                // with 16-bit "digits"). Cannot overflow: high<=(2^16-1)^2
+                const uint32_t upper = high + (low >> 16U);
+                const uint32_t upperQuotient = divide(upper, (uint16_t)divisor);
+                const uint32_t remainder = upper - (upperQuotient * divisor);
+                const uint32_t lowerQuotient = divide((uint32_t)((remainder << 16U) | (uint16_t)low), (uint16_t)divisor);
+                // Same as the low 32 bits of a 64-bit quotient, even if the 
+                // quotient overflows
+                return (uint32_t)(upperQuotient << 16U) + lowerQuotient;
+            }
+        }
+        // Both operands are wider than 16 bits (or the product & divisor are too wide)
+        return (uint32_t)divide((uint64_t)a * b, divisor);
+    }
+
+    template <typename TA, typename TB, typename TDivisor>
+    static inline uint64_t mulDiv(const TA &a, const TB &b, const TDivisor &divisor, product_width_tag<sizeof(uint64_t)>) {
+        return mulDiv32(a, b, divisor);
+    }
+
+    // (a * b) / divisor for unsigned values, with no overflow. The result type is the 
+    // same as safeMultiply(a, b), but the calculation uses the narrowest
+    // multiply & divide that the actual values allow.
+    template <typename TA, typename TB, typename TDivisor>
+    static inline auto mulDiv(const TA &a, const TB &b, const TDivisor &divisor) 
+        -> decltype(safeMultiply(a, b)) {
+        typedef decltype(safeMultiply(a, b)) product_t;
+        // The run time checks are for 2 operands & a divisor of the same width: 
+        // anything else uses the generic version
+        return mulDiv(a, b, divisor, 
+                      product_width_tag<(sizeof(TA)*2U<=sizeof(product_t) && sizeof(TB)*2U<=sizeof(product_t) && sizeof(TDivisor)*2U<=sizeof(product_t)) 
+                                        ? sizeof(product_t) : 0U>());
+    }
+
+#if defined(FAST_MAP_AVR_ASM)
+    // Hand written kernels for the 8x8 & mixed 8/16-bit cases. avr-gcc calls
+    // a generic library routine for each division: these use a MUL based product
+    // & a restoring division with only as many steps as the quotient has bits.
+    //
+    // Each division requires the high part of the dividend to be less than the
+    // divisor, so the quotient fits in the loop's bits. That is always true for
+    // in range inputs (m<=inRange), so out of range inputs use divide().
+    //
+    // The unit tests check the 8x8 kernel for every multiplier & divisor pair, and the
+    // mixed 8/16-bit kernels through fast_map() over every input of a range, against
+    // the exact results. Run them in the asm simulator environments: the CYCLES rows
+    // give the measured cost, compared to the C code in the other environments.
+
+    // 16/8 division, with an 8-bit quotient. Requires high<divisor.
+    static inline uint8_t divide16By8(uint8_t high, uint8_t low, uint8_t divisor) {
+        uint8_t counter;
+        asm (
+            "ldi  %[counter], 8\n"
+        "1:\n\t"
+            "lsl  %[low]\n\t"
+            "rol  %[high]\n\t"
+            "brcs 2f\n\t"               // Remainder>255, so must be >divisor
+            "cp   %[high], %[divisor]\n\t"
+            "brlo 3f\n"
+        "2:\n\t"
+            "sub  %[high], %[divisor]\n\t"
+            "inc  %[low]\n"             // Set the quotient bit
+        "3:\n\t"
+            "dec  %[counter]\n\t"
+            "brne 1b\n\t"
+            : [low] "+r" (low), [high] "+r" (high), [counter] "=&d" (counter)
+            : [divisor] "r" (divisor)
+        );
+        return low;
+    }
+
+    // 24/8 division, with a 16-bit quotient. Requires high<divisor.
+    static inline uint16_t divide24By8(uint8_t high, uint16_t low, uint8_t divisor) {
+        uint8_t counter;
+        asm (
+            "ldi  %[counter], 16\n"
+        "1:\n\t"
+            "lsl  %A[low]\n\t"
+            "rol  %B[low]\n\t"
+            "rol  %[high]\n\t"
+            "brcs 2f\n\t"
+            "cp   %[high], %[divisor]\n\t"
+            "brlo 3f\n"
+        "2:\n\t"
+            "sub  %[high], %[divisor]\n\t"
+            "inc  %A[low]\n"
+        "3:\n\t"
+            "dec  %[counter]\n\t"
+            "brne 1b\n\t"
+            : [low] "+r" (low), [high] "+r" (high), [counter] "=&d" (counter)
+            : [divisor] "r" (divisor)
+        );
+        return low;
+    }
+
+    // 24/16 division, with an 8-bit quotient. Requires high<divisor.
+    static inline uint8_t divide24By16(uint16_t high, uint8_t low, uint16_t divisor) {
+        uint8_t counter;
+        asm (
+            "ldi  %[counter], 8\n"
+        "1:\n\t"
+            "lsl  %[low]\n\t"
+            "rol  %A[high]\n\t"
+            "rol  %B[high]\n\t"
+            "brcs 2f\n\t"
+            "cp   %A[high], %A[divisor]\n\t"
+            "cpc  %B[high], %B[divisor]\n\t"
+            "brlo 3f\n"
+        "2:\n\t"
+            "sub  %A[high], %A[divisor]\n\t"
+            "sbc  %B[high], %B[divisor]\n\t"
+            "inc  %[low]\n"
+        "3:\n\t"
+            "dec  %[counter]\n\t"
+            "brne 1b\n\t"
+            : [low] "+r" (low), [high] "+r" (high), [counter] "=&d" (counter)
+            : [divisor] "r" (divisor)
+        );
+        return low;
+    }
+
+    // 16x8=>24 multiply, from 2 MULs.
+    static inline __uint24 multiply16x8(uint16_t a, uint8_t b) {
+        __uint24 product;
+        asm (
+            "mul  %A[a], %[b]\n\t"
+            "mov  %A[product], r0\n\t"
+            "mov  %B[product], r1\n\t"
+            "mul  %B[a], %[b]\n\t"
+            "add  %B[product], r0\n\t"
+            "mov  %C[product], r1\n\t"
+            "clr  __zero_reg__\n\t"     // Doesn't change the carry flag
+            "adc  %C[product], __zero_reg__\n\t"
+            : [product] "=&r" (product)
+            : [a] "r" (a), [b] "r" (b)
+        );
+        return product;
+    }
+
+    // u8 inputs, u8 outputs.
+    static inline uint16_t mulDiv(const uint8_t &a, const uint8_t &b, const uint8_t &divisor) {
+        uint8_t high, low;
+        asm (
+            "mul  %[a], %[b]\n\t"
+            "mov  %[low], r0\n\t"
+            "mov  %[high], r1\n\t"
+            "clr  __zero_reg__\n\t"
+            : [low] "=&r" (low), [high] "=&r" (high)
+            : [a] "r" (a), [b] "r" (b)
+        );
+        if (high<divisor) {
+            return divide16By8(high, low, divisor);
+        }
+        return divide((uint16_t)(((uint16_t)high << 8U) | low), divisor);
+    }
+
+    // u16 inputs, u8 outputs (E.g. ADC readings to a percentage).
+    static inline __uint24 mulDiv(const uint16_t &a, const uint8_t &b, const uint16_t &divisor) {
+        const __uint24 product = multiply16x8(a, b);
+        const uint16_t high = (uint16_t)(product >> 8U);
+        if (high<divisor) {
+            return divide24By16(high, (uint8_t)product, divisor);
+        }
+        return divide(product, divisor);
+    }
+
+    // u8 inputs, u16 outputs.
+    static inline __uint24 mulDiv(const uint8_t &a, const uint16_t &b, const uint8_t &divisor) {
+        const __uint24 product = multiply16x8(b, a);
+        const uint8_t high = (uint8_t)(product >> 16U);
+        if (high<divisor) {
+            return divide24By8(high, (uint16_t)product, divisor);
+        }
+        return divide(product, divisor);
+    }
+#endif
+
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+    // Reciprocal table: entry d is floor(2^16/d) for d<256, floor(2^24/d) otherwise 
+    // (clamped to 16 bits). Multiplying by it & keeping the high bits divides by d, 
+    // but the estimate can be 1 too small: so it's only used for dividends below 
+    // d*256 (an 8-bit quotient) & corrected with a single comparison.
+    static constexpr uint16_t clampReciprocal(uint32_t reciprocal) {
+        return (uint16_t)(reciprocal>UINT16_MAX ? UINT16_MAX : reciprocal);
+    }
+
+    static constexpr uint16_t reciprocal(size_t divisor) {
+        return divisor==0U ? (uint16_t)0U : clampReciprocal((uint32_t)((divisor<=UINT8_MAX ? 65536UL : 16777216UL)/divisor));
+    }
+
+    template <typename TIndexes> struct reciprocal_lut_storage;
+
+    template <size_t... Idx>
+    struct reciprocal_lut_storage<type_traits::index_sequence<Idx...>> {
+        static const uint16_t table[sizeof...(Idx)];
+    };
+
+    template <size_t... Idx>
+    const uint16_t reciprocal_lut_storage<type_traits::index_sequence<Idx...>>::table[sizeof...(Idx)] FAST_MAP_PROGMEM = {
+        reciprocal(Idx)...
+    };
+
+    typedef reciprocal_lut_storage<type_traits::make_index_sequence<FAST_MAP_RECIPROCAL_LUT+1U>> reciprocal_lut;
+
+    static inline uint16_t readReciprocal(const uint16_t &divisor) {
+#if defined(__AVR__)
+        return pgm_read_word(&reciprocal_lut::table[divisor]);
+#else
+        return reciprocal_lut::table[divisor];
+#endif
+    }
+
+    // One 8-bit digit of a long division: dividend/divisor, where dividend<divisor*256.
+    // The remainder is returned in dividend.
+    static inline uint8_t reciprocalDivideDigit(uint32_t &dividend, const uint16_t &divisor, const uint16_t &reciprocal) {
+        uint8_t digit;
+        if (divisor<=UINT8_MAX) {
+            // Dividend is at most 16 bits
+            digit = (uint8_t)(((uint32_t)(uint16_t)dividend * reciprocal) >> 16U);
+        } else {
+            digit = (uint8_t)(((uint32_t)dividend * reciprocal) >> 24U);
+        }
+        uint16_t remainder = (uint16_t)(dividend - (uint32_t)digit * divisor);
+        if (remainder>=divisor) {
+            remainder = (uint16_t)(remainder - divisor);
+            ++digit;
+        }
+        dividend = remainder;
+        return digit;
+    }
+
+    // (m * outRange) / divisor, for m<=divisor<=FAST_MAP_RECIPROCAL_LUT: so the 
+    // quotient fits in TOut. Long division with 8-bit digits, each using a multiply
+    // by the reciprocal instead of a division.
+    template <typename TOut>
+    static inline TOut reciprocalMulDiv(const uint16_t &m, const TOut &outRange, const uint16_t &divisor) {
+        static_assert(sizeof(TOut)<=sizeof(uint16_t), "Quotient must be at most 16 bits");
+        const uint16_t reciprocal = readReciprocal(divisor);
+        const uint32_t dividend = (uint32_t)m * outRange;
+        // Less than divisor, since m<=divisor
+        uint32_t remainder = dividend >> (sizeof(TOut)*8U);
+        TOut quotient = 0U;
+        for (uint8_t digit = sizeof(TOut); digit>0U; --digit) {
+            remainder = (remainder << 8U) | (uint8_t)(dividend >> ((digit-1U)*8U));
+            quotient = (TOut)(((uint32_t)quotient << 8U) | reciprocalDivideDigit(remainder, divisor, reciprocal));
+        }
+        return quotient;
+    }
+#endif
+
+    template <bool useReciprocal> struct reciprocal_tag { };
+
+    // (m * outRange) / inRange, for map(): uses the reciprocal table if it's enabled,
+    // covers inRange & the result fits in the output type (in range inputs).
+    template <typename TIn, typename TOut>
+    static inline TOut mulDivReciprocal(const TIn &m, const TOut &outRange, const TIn &inRange, reciprocal_tag<false>) {
+        return (TOut)mulDiv(m, outRange, inRange);
+    }
+
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+    template <typename TIn, typename TOut>
+    static inline TOut mulDivReciprocal(const TIn &m, const TOut &outRange, const TIn &inRange, reciprocal_tag<true>) {
+        if ((uint32_t)inRange<=(uint32_t)FAST_MAP_RECIPROCAL_LUT && m<=inRange) {
+            return reciprocalMulDiv((uint16_t)m, outRange, (uint16_t)inRange);
+        }
+        return (TOut)mulDiv(m, outRange, inRange);
+    }
+#endif
+
+    template <typename TIn, typename TOut>
+    static inline TOut mulDivReciprocal(const TIn &m, const TOut &outRange, const TIn &inRange) {
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+        return mulDivReciprocal(m, outRange, inRange, reciprocal_tag<(sizeof(TOut)<=sizeof(uint16_t))>());
+#else
+        return mulDivReciprocal(m, outRange, inRange, reciprocal_tag<false>());
+#endif
+    }
+
+    // Compute a fixed point reciprocal for the fractional part of a map
+    // operation: ceil((remainder << (2*bits)) / divisor), where remainder<divisor.
+    //
+    // Long division, one bit at a time, so we never need an integral type wider 
+    // than the result. Since this only runs when a mapper is constructed,
+    // speed isn't a concern.
+    template <typename T>
+    static inline widen_integral_t<T> fixedPointReciprocal(T remainder, const T &divisor) {
+        typedef widen_integral_t<T> TWide;
+        TWide rem = remainder;
+        TWide recip = 0;
+        // Not sizeof(TWide): 24-bit types widen to 64-bits
+        for (uint8_t bit=0; bit<sizeof(T)*2U*8U; ++bit) {
+            rem = (TWide)(rem << 1U);
+            recip = (TWide)(recip << 1U);
+            if (rem>=divisor) {
+                rem = (TWide)(rem - divisor);
+                recip = (TWide)(recip | 1U);
+            }
+        }
+        // Round up, so the reciprocal never under-estimates
+        return (TWide)(recip + (rem!=0U ? 1U : 0U));
+    }
+
+    // Equivalent of (a * recip) >> (2*bits), where recip is the double width 
+    // value from fixedPointReciprocal().
+    //
+    // Split into 2 single width multiplies: this avoids needing an integral type
+    // 4x the width of T. E.g. for 16-bit inputs we use 2 16x16=>32 multiplies
+    // instead of a 16x32=>64 multiply.
+    template <typename T>
+    static inline T multiplyHigh(const T &a, const widen_integral_t<T> &recip) {
+        typedef widen_integral_t<T> TWide;
+        constexpr uint8_t bits = sizeof(T)*8U;
+        const TWide high = safeMultiply(a, (T)(recip >> bits));
+        const TWide low = safeMultiply(a, (T)recip);
+        // Cannot overflow: high <= (2^bits-1)^2 & (low >> bits) < 2^bits
+        return (T)((TWide)(high + (low >> bits)) >> bits);
+    }
+
+    // (m * outRange) / inRange, where:
+    //   quotient == outRange / inRange
+    //   recip == fixedPointReciprocal(outRange % inRange, inRange)
+    //
+    // Only valid for m<=inRange: in that case (m * quotient)<=outRange and cannot 
+    // overflow. Also, if quotient!=0 then m<=outRange so narrowing m is safe.
+    template <typename TIn, typename TOut>
+    static inline TOut scaleByReciprocal(const TIn &m, const TOut &quotient, const widen_integral_t<TIn> &recip) {
+        return (TOut)((TOut)((TOut)m * quotient) + multiplyHigh(m, recip));
+    }
+
+    // ceil((m * numerator) / denominator)
+    //
+    // The rounding is folded into the division: cannot overflow since
+    // (2^n-1)*(2^k-1) + (2^k-1) < 2^(n+k)
+    template <typename TM, typename TNumerator>
+    static inline TNumerator scaleRoundUp(const TM &m, const TNumerator &numerator, const TM &denominator) {
+        const auto product = safeMultiply(m, numerator);
+        return (TNumerator)divide((decltype(product))(product + (TM)(denominator-1U)), denominator);
+    }
+
+    // Compile time equivalent of fixedPointReciprocal(). 
+    //
+    // C++11 constexpr functions cannot loop, so this recurses once per bit.
+    template <typename TWide>
+    static inline constexpr TWide constReciprocalStep(TWide rem, TWide recip, TWide divisor, uint8_t bitsLeft) {
+        return bitsLeft==0U ? (TWide)(recip + (rem!=0U ? 1U : 0U))
+            : (TWide)(rem << 1U)>=divisor 
+                ? constReciprocalStep((TWide)((TWide)(rem << 1U) - divisor), (TWide)((TWide)(recip << 1U) | 1U), divisor, (uint8_t)(bitsLeft-1U))
+                : constReciprocalStep((TWide)(rem << 1U), (TWide)(recip << 1U), divisor, (uint8_t)(bitsLeft-1U));
+    }
+    template <typename T>
+    static inline constexpr widen_integral_t<T> constFixedPointReciprocal(T remainder, T divisor) {
+        return constReciprocalStep<widen_integral_t<T>>(remainder, 0U, divisor, (uint8_t)(sizeof(T)*2U*8U));
+    }
+
+    static inline constexpr uint32_t constAbsDelta(int32_t min, int32_t max) {
+        return max<min ? (uint32_t)min - (uint32_t)max : (uint32_t)max - (uint32_t)min;
+    }
+
+    static inline constexpr bool isPowerOfTwo(uint32_t value) {
+        return value!=0U && (value & (value-1U))==0U;
+    }
+
+    static inline constexpr uint8_t constLog2(uint32_t value) {
+        return value<=1U ? 0U : (uint8_t)(1U + constLog2(value >> 1U));
+    }
+
+    // Can the value be stored in type T without loss?
+    template <typename T>
+    static inline constexpr bool isRepresentable(int32_t value) {
+        return (type_traits::is_signed<T>::value || value>=0) && (int32_t)(T)value==value;
+    }
+
+    // The narrowest integral type that can hold all values in the range [min, max]
+    template <int32_t min, int32_t max>
+    struct narrowest_integral {
+        typedef typename type_traits::conditional<(min>=0),
+            typename type_traits::conditional<(max<=(int32_t)UINT8_MAX), uint8_t, 
+                typename type_traits::conditional<(max<=(int32_t)UINT16_MAX), uint16_t, uint32_t>::type>::type,
+            typename type_traits::conditional<(min>=INT8_MIN && max<=INT8_MAX), int8_t, 
+                typename type_traits::conditional<(min>=INT16_MIN && max<=INT16_MAX), int16_t, int32_t>::type>::type
+            >::type type;
+    };
+    template <int32_t a, int32_t b>
+    using narrowest_integral_t = typename narrowest_integral<(a<b ? a : b), (a<b ? b : a)>::type;
+
+    // Compile time map(), for constant arguments.
+    template <typename TOut>
+    static inline constexpr TOut constMap(int32_t in, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax) {
+        // 64-bit, so this cannot overflow - unlike map()
+        return (TOut)((((int64_t)in - inMin) * ((int64_t)outMax - outMin)) / ((int64_t)inMax - inMin) + outMin);
+    }
+
+    // The fast_map() kernels that can be selected at compile time, 
+    // when the ranges are constant.
+    enum class const_map_kernel : uint8_t {
+        // inRange==outRange: a single addition (or subtraction)
+        add_only,
+        // inRange is a power of 2: multiply & shift
+        shift,
+        // Any other range: multiply by reciprocal
+        reciprocal,
+    };
+    template <const_map_kernel kernel> struct const_map_kernel_tag { };
+
+    // Compile time analysis of constant ranges
+    template <typename TIn, typename TOut, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax>
+    struct const_ranges {
+        static_assert(inMin!=inMax, "Input range cannot be empty");
+        static_assert(isRepresentable<TIn>(inMin) && isRepresentable<TIn>(inMax), "inMin & inMax must fit in the input type");
+        static_assert(isRepresentable<TOut>(outMin) && isRepresentable<TOut>(outMax), "outMin & outMax must fit in the output type");
+
+        typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+        typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+        static constexpr in_unsigned_t inRange = (in_unsigned_t)constAbsDelta(inMin, inMax);
+        static constexpr out_unsigned_t outRange = (out_unsigned_t)constAbsDelta(outMin, outMax);
+        static constexpr bool rangesOpposed = (inMax<inMin)!=(outMax<outMin);
+        static constexpr const_map_kernel kernel = 
+            (uint32_t)inRange==(uint32_t)outRange ? const_map_kernel::add_only 
+          : isPowerOfTwo(inRange) ? const_map_kernel::shift 
+          : const_map_kernel::reciprocal;
+    };
 }
 
 /// @endcond
 
+/// @cond
+namespace fast_map_impl {
+
+    // Map an input position to the output range.
+    //
+    // m: absolute distance of the input from inMin
+    // inOpposite: the input is on the opposite side of inMin to inMax
+    template <typename TIn, typename TOut>
+    static inline TOut mapPosition(const TIn &m, const TIn &inRange, bool inOpposite, TOut outMin, TOut outMax) {
+        /* Float version (if m, yMax, yMin and n were float's)
+            int yVal = (m * (yMax - yMin)) / n;
+        */
+        typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+        const out_unsigned_t outRange = absDelta(outMin, outMax);
+        // mulDiv() & divide() will do the heavy lifting of optimizing integral type 
+        // widths, so no impact even if the product type is bigger than necessary
+        const out_unsigned_t scaled = mulDivReciprocal(m, outRange, inRange);
+
+        const bool outRangeInverted = (outMax<outMin);
+        if (inOpposite!=outRangeInverted) {
+          return (TOut)(outMin - scaled);     
+        }
+        return (TOut)(outMin + scaled);    
+    }
+
+    template <typename TIn, typename TOut>
+    static inline TOut mapInline(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+        // We use unsigned types for performance and to avoid integer overflow.
+        typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+
+        const in_unsigned_t m = fast_map_impl::absDelta(inMin, in);
+        const in_unsigned_t inRange = fast_map_impl::absDelta(inMin, inMax);
+        // Since we use unsigned types to avoid under/overflow, we need to adjust for a few cases
+        // where the result should be less than outMin
+        const bool inLowerThanInMin = (in<inMin);
+        const bool inRangeInverted = (inMax<inMin);
+        const bool inOpposite = inLowerThanInMin!=inRangeInverted;
+        return fast_map_impl::mapPosition(m, inRange, inOpposite, outMin, outMax);
+    }
+
+#if defined(FAST_MAP_OPTIMIZE_SIZE)
+    // Offsetting by the sign bit maps signed values onto unsigned values with the 
+    // same order & the same differences (modulo 2^bits). So signed & unsigned types of
+    // the same width can share a kernel. The offset is its own inverse.
+    template <typename T>
+    static inline fast_map_impl::make_unsigned_t<T> toOffsetBinary(const T &value) {
+        typedef fast_map_impl::make_unsigned_t<T> unsigned_t;
+        return (unsigned_t)((unsigned_t)value ^ (type_traits::is_signed<T>::value ? (unsigned_t)((unsigned_t)1U << (sizeof(T)*8U-1U)) : (unsigned_t)0U));
+    }
+
+    // One out of line copy for each input & output width, shared by every call site. 
+    // Not static, so the linker also merges the copies from each translation unit.
+    template <typename TIn, typename TOut>
+    __attribute__((noinline)) inline TOut mapKernel(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+        return mapInline(in, inMin, inMax, outMin, outMax);
+    }
+#endif
+}
+/// @endcond
+
 /**
  * @brief Optimized version of Arduino's map() function.
  * 
@@ -119,6 +835,13 @@ namespace fast_map_impl {
  * 
  * (see unit tests)
  * 
+ * Inlined by default. If flash is tight, define FAST_MAP_OPTIMIZE_SIZE (for the whole
+ * build): each call site then only passes the arguments to an out of line kernel,
+ * shared by all calls with the same input & output type widths. Results are
+ * identical, at the cost of a function call per map.
+ * 
+ * Integral types only: for float arguments, see avr-fast-map-float.h.
+ * 
  * @tparam TIn Input range type
  * @tparam TOut Output range type
  * @param in Input value
@@ -129,39 +852,763 @@ namespace fast_map_impl {
  * @return TOut
  */
 template <typename TIn, typename TOut>
-static inline TOut fast_map(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
-    /* Float version (if m, yMax, yMin and n were float's)
-        int yVal = (m * (yMax - yMin)) / n;
-    */
-    // We use unsigned types for performance and to avoid integer overflow.
-    typedef typename type_traits::make_unsigned_t<TIn> in_unsigned_t;
-    typedef typename type_traits::make_unsigned_t<TOut> out_unsigned_t;
+static inline fast_map_impl::integral_map_t<TIn, TOut> fast_map(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+#if defined(FAST_MAP_OPTIMIZE_SIZE)
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+    using fast_map_impl::toOffsetBinary;
+    const out_unsigned_t result = fast_map_impl::mapKernel<in_unsigned_t, out_unsigned_t>(
+                                    toOffsetBinary(in), toOffsetBinary(inMin), toOffsetBinary(inMax),
+                                    toOffsetBinary(outMin), toOffsetBinary(outMax));
+    return (TOut)toOffsetBinary((TOut)result);
+#else
+    return fast_map_impl::mapInline(in, inMin, inMax, outMin, outMax);
+#endif
+}
+
+/**
+ * @brief A pre-computed fast_map() for a fixed set of ranges.
+ * 
+ * If the same ranges are used for many calls, this removes almost all the per call
+ * set up work *and* the division: the ranges, direction flags and a fixed point
+ * reciprocal of the input range are computed once, in the constructor.
+ * 
+ * For inputs within the input range, each map() call then costs 
+ * 2 narrow multiplies & some shifts. Inputs outside the input range 
+ * fall back to a division.
+ * 
+ * Results are identical to fast_map() (and therefore Arduino's map()).
+ * 
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <typename TIn, typename TOut>
+class fast_mapper {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+public:
+    /**
+     * @brief Construct a new mapper object
+     * 
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum
+     */
+    fast_mapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax)
+        : _inMin(inMin)
+        , _outMin(outMin)
+        , _inRange(fast_map_impl::absDelta(inMin, inMax))
+        , _outRange(fast_map_impl::absDelta(outMin, outMax))
+        , _rangesOpposed((inMax<inMin)!=(outMax<outMin))
+        // _outRange == (_quotient * _inRange) + remainder
+        , _quotient((out_unsigned_t)(_outRange / _inRange))
+        , _recip(fast_map_impl::fixedPointReciprocal((in_unsigned_t)(_outRange % _inRange), _inRange))
+    {
+    }
+
+    /**
+     * @brief Map a value from the input range to the output range
+     * 
+     * @param in Input value
+     * @return TOut 
+     */
+    TOut map(TIn in) const {
+        const in_unsigned_t m = fast_map_impl::absDelta(_inMin, in);
+        const out_unsigned_t scaled = scale(m);
+        if ((in<_inMin)!=_rangesOpposed) {
+            return (TOut)(_outMin - scaled);     
+        }
+        return (TOut)(_outMin + scaled);    
+    }
+
+    /**
+     * @brief Map a buffer of values: equivalent to calling map() for each element.
+     * 
+     * On AVR, the loop is unrolled: the loop overhead is significant compared to the 
+     * cost of each map operation. Elsewhere, values are mapped in blocks with a branch
+     * free loop body that the compiler can vectorize (E.g. SSE/NEON at -O3). A block
+     * containing an out of range input is re-mapped with map().
+     * 
+     * @param in Input values
+     * @param out Output values. Can be the same buffer as in (if TIn and TOut are the same type)
+     * @param n Number of values
+     */
+    void map_n(const TIn *in, TOut *out, size_t n) const {
+#if defined(__AVR__)
+        for (; n>=4U; n = n-4U) {
+            out[0] = map(in[0]);
+            out[1] = map(in[1]);
+            out[2] = map(in[2]);
+            out[3] = map(in[3]);
+            in = in + 4U;
+            out = out + 4U;
+        }
+#else
+        for (; n>=block_size; n = n-block_size) {
+            map_block(in, out);
+            in = in + block_size;
+            out = out + block_size;
+        }
+#endif
+        for (; n!=0U; --n) {
+            *out++ = map(*in++);
+        }
+    }
+
+private:
+#if !defined(__AVR__)
+    static constexpr uint8_t block_size = 16U;
+
+    void map_block(const TIn *in, TOut *out) const {
+        // Mapped into a separate block, so in place mapping can fall back to map()
+        TOut block[block_size];
+        in_unsigned_t offsets[block_size];
+        for (uint8_t index=0; index<block_size; ++index) {
+            offsets[index] = fast_map_impl::absDelta(_inMin, in[index]);
+        }
+        // Separate loops: the compiler won't vectorize the reduction together with the map
+        in_unsigned_t maxOffset = 0U;
+        for (uint8_t index=0; index<block_size; ++index) {
+            maxOffset = offsets[index]>maxOffset ? offsets[index] : maxOffset;
+        }
+        if (maxOffset>_inRange) {
+            for (uint8_t index=0; index<block_size; ++index) {
+                block[index] = map(in[index]);
+            }
+        } else {
+            for (uint8_t index=0; index<block_size; ++index) {
+                const out_unsigned_t scaled = fast_map_impl::scaleByReciprocal(offsets[index], _quotient, _recip);
+                block[index] = ((in[index]<_inMin)!=_rangesOpposed) ? (TOut)(_outMin - scaled) : (TOut)(_outMin + scaled);
+            }
+        }
+        for (uint8_t index=0; index<block_size; ++index) {
+            out[index] = block[index];
+        }
+    }
+#endif
+
+    // (m * _outRange) / _inRange
+    out_unsigned_t scale(const in_unsigned_t &m) const {
+        if (m<=_inRange) {
+            return fast_map_impl::scaleByReciprocal(m, _quotient, _recip);
+        }
+        // Out of range input: this is rare, so use the slow path.
+        return (out_unsigned_t)fast_map_impl::mulDiv(m, _outRange, _inRange);
+    }
+
+protected:
+    TIn _inMin;
+    TOut _outMin;
+    in_unsigned_t _inRange;
+    out_unsigned_t _outRange;
+    bool _rangesOpposed;
+
+private:
+    out_unsigned_t _quotient;
+    fast_map_impl::widen_integral_t<in_unsigned_t> _recip;
+};
+
+/**
+ * @brief A fast_mapper that can also map from the output range back to the input range.
+ * 
+ * The ranges & direction flags are shared with the forward map: the inverse only adds
+ * a second pre-computed reciprocal (of the output range). So, like map(), unmap() 
+ * needs no division for values within the output range. This includes the common case
+ * of an output range narrower than the input range: the inverse then expands the value,
+ * which fast_unmap() would do with a division.
+ * 
+ * Results are identical to fast_unmap(): see there for the round trip guarantees.
+ * 
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ */
+template <typename TIn, typename TOut>
+class fast_bimapper : public fast_mapper<TIn, TOut> {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+public:
+    /**
+     * @brief Construct a new mapper object
+     * 
+     * @param inMin Input range minimum
+     * @param inMax Input range maximum (must not equal inMin)
+     * @param outMin Output range minimum
+     * @param outMax Output range maximum (must not equal outMin)
+     */
+    fast_bimapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax)
+        : fast_mapper<TIn, TOut>(inMin, inMax, outMin, outMax)
+        // _inRange == (_inverseQuotient * _outRange) + _inverseRemainder
+        , _inverseQuotient((in_unsigned_t)(this->_inRange / this->_outRange))
+        , _inverseRemainder((out_unsigned_t)(this->_inRange % this->_outRange))
+        , _inverseRecip(fast_map_impl::fixedPointReciprocal(_inverseRemainder, this->_outRange))
+    {
+    }
+
+    /**
+     * @brief Map a value from the output range back to the input range
+     * 
+     * @param out Output range value
+     * @return TIn 
+     */
+    TIn unmap(TOut out) const {
+        const out_unsigned_t m = fast_map_impl::absDelta(this->_outMin, out);
+        const in_unsigned_t scaled = unscale(m);
+        if ((out<this->_outMin)!=this->_rangesOpposed) {
+            return (TIn)(this->_inMin - scaled);     
+        }
+        return (TIn)(this->_inMin + scaled);    
+    }
+
+private:
+    // ceil((m * _inRange) / _outRange)
+    in_unsigned_t unscale(const out_unsigned_t &m) const {
+        if (m<=this->_outRange) {
+            const out_unsigned_t fraction = fast_map_impl::multiplyHigh(m, _inverseRecip);
+            // Round up if the division isn't exact
+            const bool roundUp = fast_map_impl::safeMultiply(m, _inverseRemainder)!=fast_map_impl::safeMultiply(fraction, this->_outRange);
+            return (in_unsigned_t)((in_unsigned_t)((in_unsigned_t)m * _inverseQuotient) + fraction + (roundUp ? 1U : 0U));
+        }
+        // Out of range input: this is rare, so use the slow path.
+        return fast_map_impl::scaleRoundUp(m, this->_inRange, this->_outRange);
+    }
+
+    in_unsigned_t _inverseQuotient;
+    out_unsigned_t _inverseRemainder;
+    fast_map_impl::widen_integral_t<out_unsigned_t> _inverseRecip;
+};
+
+/// @cond
+namespace fast_map_impl {
+    template <typename TRanges>
+    static inline typename TRanges::out_unsigned_t constScale(const typename TRanges::in_unsigned_t &m, const_map_kernel_tag<const_map_kernel::add_only>) {
+        return (typename TRanges::out_unsigned_t)m;
+    }
+
+    template <typename TRanges>
+    static inline typename TRanges::out_unsigned_t constScale(const typename TRanges::in_unsigned_t &m, const_map_kernel_tag<const_map_kernel::shift>) {
+        typedef typename TRanges::out_unsigned_t out_unsigned_t;
+        if (m<=TRanges::inRange) {
+            // The ranges are constant, so we know the largest product at compile time
+            // & can use the narrowest type that holds it. E.g. 0-256 => 0-200 
+            // needs a 16-bit product, not 32-bit.
+            typedef uint_least_bits_t<constLog2(TRanges::inRange)+constLog2(TRanges::outRange)+1U> product_t;
+            return (out_unsigned_t)((product_t)((product_t)m * (product_t)TRanges::outRange) >> constLog2(TRanges::inRange));
+        }
+        return (out_unsigned_t)(safeMultiply(m, (out_unsigned_t)TRanges::outRange) >> constLog2(TRanges::inRange));
+    }
+
+    template <typename TRanges>
+    static inline typename TRanges::out_unsigned_t constScale(const typename TRanges::in_unsigned_t &m, const_map_kernel_tag<const_map_kernel::reciprocal>) {
+        typedef typename TRanges::in_unsigned_t in_unsigned_t;
+        typedef typename TRanges::out_unsigned_t out_unsigned_t;
+        if (m<=TRanges::inRange) {
+            constexpr out_unsigned_t quotient = (out_unsigned_t)(TRanges::outRange / TRanges::inRange);
+            constexpr widen_integral_t<in_unsigned_t> recip = 
+                constFixedPointReciprocal((in_unsigned_t)(TRanges::outRange % TRanges::inRange), TRanges::inRange);
+            return scaleByReciprocal(m, quotient, recip);
+        }
+        // Out of range input: this is rare, so use the slow path.
+        return (out_unsigned_t)mulDiv(m, (out_unsigned_t)TRanges::outRange, (in_unsigned_t)TRanges::inRange);
+    }
+}
+/// @endcond
+
+/**
+ * @brief fast_map() for constant ranges.
+ * 
+ * Since the ranges are known at compile time, the fastest kernel is selected
+ * at compile time and no division is required for inputs within the input range:
+ *  * Input & output ranges are the same size: a single addition 
+ *  * Input range is a power of 2: a multiply & shift 
+ *  * Otherwise: a multiply by a pre-computed reciprocal
+ * 
+ * E.g. @code fast_map<0, 1023, 0, 255>(analogRead(A0)) @endcode
+ * 
+ * Results are identical to fast_map() (and therefore Arduino's map()).
+ * 
+ * @tparam inMin Input range minimum
+ * @tparam inMax Input range maximum
+ * @tparam outMin Output range minimum
+ * @tparam outMax Output range maximum
+ * @tparam TOut Output range type. Defaults to the narrowest type that can hold the output range.
+ * @tparam TIn Input range type
+ * @param in Input value
+ * @return TOut
+ */
+template <int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax,
+          typename TOut = fast_map_impl::narrowest_integral_t<outMin, outMax>,
+          typename TIn>
+static inline TOut fast_map(TIn in) {
+    typedef fast_map_impl::const_ranges<TIn, TOut, inMin, inMax, outMin, outMax> ranges_t;
+    typedef typename ranges_t::out_unsigned_t out_unsigned_t;
+
+    const out_unsigned_t scaled = fast_map_impl::constScale<ranges_t>(
+                                    fast_map_impl::absDelta((TIn)inMin, in), 
+                                    fast_map_impl::const_map_kernel_tag<ranges_t::kernel>());
+    if ((in<(TIn)inMin)!=ranges_t::rangesOpposed) {
+      return (TOut)((TOut)outMin - scaled);     
+    }
+    return (TOut)((TOut)outMin + scaled);    
+}
+
+/**
+ * @brief How fast_map_constrain() handles inputs outside the input range
+ */
+enum class fast_map_mode : uint8_t {
+    /** @brief Extend the line beyond the output range (same as fast_map() & map()) */
+    extrapolate,
+    /** @brief Saturate: the result is always within the output range */
+    clamp,
+    /** @brief Treat the input range as periodic (E.g. angles): out of range inputs wrap around */
+    wrap,
+};
+
+/// @cond
+namespace fast_map_impl {
+    template <typename T>
+    static inline T selectMask(bool condition);
+
+    // Saturate an out of range input position to the input range, without branches:
+    // positions before inMin become 0, positions beyond inMax become inRange.
+    template <typename TIn>
+    static inline void clampPosition(TIn &m, bool &inOpposite, const TIn &inRange) {
+        const TIn below = selectMask<TIn>(inOpposite);
+        const TIn above = selectMask<TIn>(m>inRange);
+        m = (TIn)(((m & (TIn)~above) | (inRange & above)) & (TIn)~below);
+        inOpposite = false;
+    }
+
+    // Wrap an out of range input position back into the input range
+    template <typename TIn>
+    static inline void wrapPosition(TIn &m, bool &inOpposite, const TIn &inRange) {
+        if (inOpposite) {
+            const TIn remainder = (TIn)(m % inRange);
+            m = remainder==0U ? (TIn)0U : (TIn)(inRange - remainder);
+            inOpposite = false;
+        } else if (m>inRange) {
+            m = (TIn)(m % inRange);
+        }
+    }
+}
+/// @endcond
+
+/**
+ * @brief fast_map() with control over inputs outside the input range.
+ * 
+ * Replaces E.g. constrain(fast_map(...), outMin, outMax): the range checks reuse 
+ * the values fast_map() computes anyway. Clamping is branch free: the input position
+ * is saturated with masks (no compare & branch pairs), then mapped as usual. So
+ * clamped inputs cost the same as in range inputs.
+ * 
+ * @tparam mode How to handle inputs outside the input range
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return TOut
+ */
+template <fast_map_mode mode = fast_map_mode::clamp, typename TIn, typename TOut>
+static inline TOut fast_map_constrain(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+
+    in_unsigned_t m = fast_map_impl::absDelta(inMin, in);
+    const in_unsigned_t inRange = fast_map_impl::absDelta(inMin, inMax);
+    bool inOpposite = (in<inMin)!=(inMax<inMin);
+    if (mode==fast_map_mode::clamp) {
+        fast_map_impl::clampPosition(m, inOpposite, inRange);
+    } else if (mode==fast_map_mode::wrap) {
+        fast_map_impl::wrapPosition(m, inOpposite, inRange);
+    }
+    return fast_map_impl::mapPosition(m, inRange, inOpposite, outMin, outMax);
+}
+
+/**
+ * @brief fast_map(), rounding to the nearest integer instead of truncating.
+ * 
+ * Ties are rounded away from outMin. The rounding is folded into the division
+ * (by adding half the divisor to the dividend), so this costs the same as fast_map().
+ * 
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return TOut
+ */
+template <typename TIn, typename TOut>
+static inline TOut fast_map_round(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
 
     const in_unsigned_t m = fast_map_impl::absDelta(inMin, in);
     const in_unsigned_t inRange = fast_map_impl::absDelta(inMin, inMax);
     const out_unsigned_t outRange = fast_map_impl::absDelta(outMin, outMax);
-    // fast_div will do the heavy lifting of optimizing integral type widths,
-    // so no impact even if safeMultiply returns a bigger than necessary type
-    const out_unsigned_t scaled = (out_unsigned_t)fast_div(fast_map_impl::safeMultiply(m, outRange), inRange);
-
-    // Since we use unsigned types to avoid under/overflow, we need to adjust for a few cases
-    // where the result should be less than outMin
-    const bool inLowerThanInMin = (in<inMin);
-    const bool inRangeInverted = (inMax<inMin);
-    const bool inOpposite = inLowerThanInMin!=inRangeInverted;
-    const bool outRangeInverted = (outMax<outMin);
-    if (inOpposite!=outRangeInverted) {
+    // Cannot overflow: the product is at most (2^n-1)*(2^k-1) & the bias less than 2^(n-1)
+    const auto product = fast_map_impl::safeMultiply(m, outRange);
+    const out_unsigned_t scaled = (out_unsigned_t)fast_map_impl::divide((decltype(product))(product + (inRange >> 1U)), inRange);
+
+    const bool inOpposite = (in<inMin)!=(inMax<inMin);
+    if (inOpposite!=(outMax<outMin)) {
       return (TOut)(outMin - scaled);     
     }
     return (TOut)(outMin + scaled);    
 }
-#else
 
-#include <Arduino.h>
+/**
+ * @brief fast_map() of the mean of a number of samples, from their sum (E.g. an 
+ * oversampled ADC reading).
+ * 
+ * Equivalent to fast_map(sum/count, inMin, inMax, outMin, outMax) with the *exact*
+ * mean: the fractional part of the mean isn't thrown away. Instead of dividing
+ * twice, the count is folded into the input range (count*inMin to count*inMax), so 
+ * this is a single multiply & divide.
+ * 
+ * If count is a constant (see fast_map_accumulated<count>()), the multiplications by
+ * the count are folded into shifts or constants by the compiler.
+ * 
+ * @note count*inMin & count*inMax must fit in TSum (which is true if TSum can hold 
+ * the sum of count samples at either end of the input range).
+ * 
+ * @tparam TSum Sum type
+ * @tparam TIn Input range type (the type of a single sample)
+ * @tparam TOut Output range type
+ * @param sum Sum of the samples
+ * @param count Number of samples (must not be zero)
+ * @param inMin Input range minimum, for a single sample
+ * @param inMax Input range maximum, for a single sample
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return TOut
+ */
+template <typename TSum, typename TIn, typename TOut>
+static inline TOut fast_map_accumulated(TSum sum, uint8_t count, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    static_assert(sizeof(TSum)>=sizeof(TIn), "Sum type must be at least as wide as the input type");
+    static_assert(type_traits::is_signed<TSum>::value==type_traits::is_signed<TIn>::value, "Sum & input types must both be signed or unsigned");
+    typedef typename fast_map_impl::make_unsigned_t<TSum> sum_unsigned_t;
+
+    // Multiply as unsigned: the result is the same, without signed overflow
+    const TSum sumInMin = (TSum)((sum_unsigned_t)count * (sum_unsigned_t)(TSum)inMin);
+    const sum_unsigned_t sumInRange = (sum_unsigned_t)((sum_unsigned_t)count * (sum_unsigned_t)fast_map_impl::absDelta(inMin, inMax));
+
+    const sum_unsigned_t m = fast_map_impl::absDelta(sumInMin, sum);
+    const bool inOpposite = (sum<sumInMin)!=(inMax<inMin);
+    return fast_map_impl::mapPosition(m, sumInRange, inOpposite, outMin, outMax);
+}
+
+/**
+ * @brief fast_map_accumulated(), for a constant number of samples: E.g. a power of 2 
+ * count is applied with shifts.
+ * 
+ * @see fast_map_accumulated()
+ */
+template <uint8_t count, typename TSum, typename TIn, typename TOut>
+static inline TOut fast_map_accumulated(TSum sum, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    static_assert(count>0U, "Count must not be zero");
+    return fast_map_accumulated(sum, count, inMin, inMax, outMin, outMax);
+}
+
+/// @cond
+namespace fast_map_impl {
+
+    // Selects the fixedMulDiv() implementation: does the shifted product fit in 64 bits?
+    template <bool fits> struct fixed_dividend_tag { };
+
+    // ((a * b) << fracBits) / divisor, in one division
+    template <uint8_t fracBits, typename TResult, typename TA, typename TB>
+    static inline TResult fixedMulDiv(const TA &a, const TB &b, const TA &divisor, fixed_dividend_tag<true>) {
+        // Must hold the product & the fractional bits
+        typedef uint_least_bits_t<(sizeof(TA)+sizeof(TB))*8U+fracBits> dividend_t;
+        const dividend_t dividend = (dividend_t)((dividend_t)((dividend_t)a * b) << fracBits);
+        return (TResult)divide(dividend, divisor);
+    }
+
+    // ((a * b) << fracBits) / divisor, where the shifted product is wider than 64 bits
+    // (E.g. 32-bit outputs): divide the product, then the shifted remainder. The
+    // remainder is less than the divisor, so the shifted remainder fits.
+    template <uint8_t fracBits, typename TResult, typename TA, typename TB>
+    static inline TResult fixedMulDiv(const TA &a, const TB &b, const TA &divisor, fixed_dividend_tag<false>) {
+        typedef uint_least_bits_t<(sizeof(TA)+sizeof(TB))*8U> product_t;
+        typedef uint_least_bits_t<sizeof(TA)*8U+fracBits> remainder_t;
+        const product_t product = (product_t)((product_t)a * b);
+        const product_t quotient = divide(product, divisor);
+        const remainder_t remainder = (remainder_t)(product - (quotient * divisor));
+        return (TResult)((TResult)((TResult)quotient << fracBits) + (TResult)divide((remainder_t)(remainder << fracBits), divisor));
+    }
+}
+/// @endcond
 
+/**
+ * @brief fast_map(), returning a fixed point result.
+ * 
+ * Keeps the fractional part of the result, E.g. for later interpolation or PID stages, 
+ * from a single division. The default is the same number of fractional bits as TOut
+ * (I.e. Q8.8 for 8-bit outputs, Q16.16 for 16-bit outputs). 
+ * 
+ * Like fast_map(), the result is truncated towards outMin (at the fixed point resolution).
+ * 
+ * @note Unless the combined width of the input type, output type & fractional bits is 
+ * 32-bits or less, this needs a 64-bit division. If it is more than 64-bits (E.g. the
+ * default Q32.32 for 32-bit outputs), it needs 2 divisions.
+ * 
+ * @tparam fracBits Number of fractional bits
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return Fixed point value, with fracBits fractional bits
+ */
+template <uint8_t fracBits, typename TIn, typename TOut>
+static inline fast_map_impl::widen_integral_t<TOut> fast_map_fixed(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    static_assert(fracBits<=sizeof(TOut)*8U, "Too many fractional bits for the output type");
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+    typedef fast_map_impl::widen_integral_t<TOut> fixed_t;
+    typedef typename fast_map_impl::make_unsigned_t<fixed_t> fixed_unsigned_t;
+
+    const in_unsigned_t m = fast_map_impl::absDelta(inMin, in);
+    const in_unsigned_t inRange = fast_map_impl::absDelta(inMin, inMax);
+    const out_unsigned_t outRange = fast_map_impl::absDelta(outMin, outMax);
+    const fixed_unsigned_t scaled = fast_map_impl::fixedMulDiv<fracBits, fixed_unsigned_t>(m, outRange, inRange,
+                                        fast_map_impl::fixed_dividend_tag<((sizeof(in_unsigned_t)+sizeof(out_unsigned_t))*8U+fracBits<=64U)>());
+    // Shift as unsigned: left shifting a negative value is undefined
+    const fixed_unsigned_t fixedOutMin = (fixed_unsigned_t)((fixed_unsigned_t)(fixed_t)outMin << fracBits);
+
+    const bool inOpposite = (in<inMin)!=(inMax<inMin);
+    if (inOpposite!=(outMax<outMin)) {
+      return (fixed_t)(fixedOutMin - scaled);     
+    }
+    return (fixed_t)(fixedOutMin + scaled);    
+}
+
+/**
+ * @brief fast_map(), returning a fixed point result with the same number of fractional 
+ * bits as TOut (I.e. Q8.8 for 8-bit outputs, Q16.16 for 16-bit outputs).
+ * 
+ * @see fast_map_fixed<fracBits>()
+ */
 template <typename TIn, typename TOut>
-static inline TOut fast_map(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
-    return (TOut)map((long)in, (long)inMin, (long)inMax, (long)outMin, (long)outMax);
+static inline fast_map_impl::widen_integral_t<TOut> fast_map_fixed(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    return fast_map_fixed<(uint8_t)(sizeof(TOut)*8U)>(in, inMin, inMax, outMin, outMax);
 }
 
-#endif
\ No newline at end of file
+/**
+ * @brief The inverse of fast_map(): map a value from the output range back to the input range.
+ * 
+ * Takes the same ranges, in the same order, as the fast_map() call it inverts.
+ * 
+ * fast_map() truncates towards outMin, so fast_unmap() rounds away from inMin. This 
+ * makes the round trip exact in whichever direction doesn't lose information:
+ *  * If the output range is at least as wide as the input range: fast_unmap(fast_map(x))==x
+ *  * Otherwise: fast_map(fast_unmap(y))==y and fast_unmap(fast_map(x)) is the first input 
+ *    that maps to the same output as x. I.e. within (inRange/outRange) of x.
+ * 
+ * For repeated calls with the same ranges, see fast_bimapper.
+ * 
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param out Output range value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum (must not equal outMin)
+ * @return TIn
+ */
+template <typename TIn, typename TOut>
+static inline TIn fast_unmap(TOut out, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+    const out_unsigned_t m = fast_map_impl::absDelta(outMin, out);
+    const in_unsigned_t inRange = fast_map_impl::absDelta(inMin, inMax);
+    const out_unsigned_t outRange = fast_map_impl::absDelta(outMin, outMax);
+    const in_unsigned_t scaled = fast_map_impl::scaleRoundUp(m, inRange, outRange);
+
+    const bool outOpposite = (out<outMin)!=(outMax<outMin);
+    if (outOpposite!=(inMax<inMin)) {
+      return (TIn)(inMin - scaled);     
+    }
+    return (TIn)(inMin + scaled);    
+}
+
+/// @cond
+namespace fast_map_impl {
+    // All ones if the condition is true, otherwise zero: for selecting without a branch
+    template <typename T>
+    static inline T selectMask(bool condition) {
+        return (T)((T)0U - (T)condition);
+    }
+
+    // absDelta(), without a branch
+    template <typename T>
+    static inline fast_map_impl::make_unsigned_t<T> constantTimeAbsDelta(const T &min, const T &max) {
+        typedef fast_map_impl::make_unsigned_t<T> unsigned_t;
+        const unsigned_t negate = selectMask<unsigned_t>(max<min);
+        const unsigned_t delta = (unsigned_t)((unsigned_t)max - (unsigned_t)min);
+        return (unsigned_t)((delta ^ negate) - negate);
+    }
+
+    // Restoring division that always takes one step per dividend bit, with no data
+    // dependent branches.
+    //
+    // The divisor must be at least 1 byte narrower than the dividend: the partial
+    // remainder is then always less than 2^(bits-1), so the sign bit of
+    // (remainder - divisor) is the borrow.
+    template <typename T, typename U>
+    static inline T constantTimeDivide(T dividend, const U &divisor) {
+        static_assert(sizeof(U)<sizeof(T), "The divisor must be narrower than the dividend");
+        typedef fast_map_impl::make_signed_t<T> signed_t;
+        constexpr uint8_t bits = (uint8_t)(sizeof(T)*8U);
+
+        T remainder = 0U;
+        for (uint8_t bit=0; bit<bits; ++bit) {
+            // Shift the next dividend bit into the remainder: the quotient bits
+            // are shifted into the dividend as it empties.
+            remainder = (T)((T)(remainder << 1U) | (T)(dividend >> (bits-1U)));
+            dividend = (T)(dividend << 1U);
+            const T difference = (T)(remainder - divisor);
+            const T borrow = (T)((signed_t)difference >> (bits-1U));
+            remainder = (T)(difference ^ ((difference ^ remainder) & borrow));
+            dividend = (T)(dividend | (T)(borrow + 1U));
+        }
+        return dividend;
+    }
+
+    // fast_map_constant_time()'s a * b / divisor: products of up to 32 bits.
+    template <typename TA, typename TB, typename TDivisor, uint8_t productBytes>
+    static inline auto constantTimeMulDiv(const TA &a, const TB &b, const TDivisor &divisor, product_width_tag<productBytes>) 
+        -> decltype(safeMultiply(a, b)) {
+        return constantTimeDivide(safeMultiply(a, b), divisor);
+    }
+
+    // 64-bit products (any 32-bit type), in 32-bit words: avr-gcc's 64-bit shifts &
+    // multiplies are library routines, & the shifts loop once per bit. The shifts 
+    // here are all by constants & the multiplies are 16x16 bits.
+    //
+    // Returns the low 32 bits of the quotient: the result type is at most 32 bits.
+    template <typename TA, typename TB, typename TDivisor>
+    static inline uint32_t constantTimeMulDiv(const TA &a, const TB &b, const TDivisor &divisor, product_width_tag<sizeof(uint64_t)>) {
+        const uint32_t x = (uint32_t)a;
+        const uint32_t y = (uint32_t)b;
+        const uint32_t d = (uint32_t)divisor;
+
+        // The product from 4 partial products
+        const uint32_t lowLow = (uint32_t)((uint32_t)(uint16_t)x * (uint16_t)y);
+        const uint32_t lowHigh = (uint32_t)((uint32_t)(uint16_t)x * (uint16_t)(y >> 16U));
+        const uint32_t highLow = (uint32_t)((uint32_t)(uint16_t)(x >> 16U) * (uint16_t)y);
+        const uint32_t highHigh = (uint32_t)((uint32_t)(uint16_t)(x >> 16U) * (uint16_t)(y >> 16U));
+        const uint32_t middle = (uint32_t)((lowLow >> 16U) + (uint16_t)lowHigh + (uint16_t)highLow);
+        uint32_t low = (uint32_t)((middle << 16U) | (uint16_t)lowLow);
+        uint32_t high = (uint32_t)(highHigh + (lowHigh >> 16U) + (highLow >> 16U) + (middle >> 16U));
+
+        // Restoring division, as constantTimeDivide(). The divisor can use all 32
+        // bits, so the partial remainder is 33 bits: the bit shifted out is kept 
+        // separately, & the borrow comes from the operands' top bits.
+        uint32_t remainder = 0U;
+        for (uint8_t bit=0; bit<64U; ++bit) {
+            const uint32_t carry = remainder >> 31U;
+            remainder = (uint32_t)((remainder << 1U) | (high >> 31U));
+            high = (uint32_t)((high << 1U) | (low >> 31U));
+            low = (uint32_t)(low << 1U);
+            const uint32_t difference = (uint32_t)(remainder - d);
+            const uint32_t borrow = (uint32_t)(((~remainder & d) | (~(remainder ^ d) & difference)) >> 31U);
+            const uint32_t subtract = carry | (borrow ^ 1U);
+            remainder = (uint32_t)(remainder ^ ((remainder ^ difference) & (uint32_t)(0U - subtract)));
+            low = low | subtract;
+        }
+        return low;
+    }
+}
+/// @endcond
+
+/**
+ * @brief fast_map(), with a fixed execution time for each type combination.
+ *
+ * fast_map()'s division takes a data dependent number of cycles, which adds jitter
+ * when called from an interrupt handler. This version uses no data dependent
+ * branches or loops: a full width restoring division & masks instead of
+ * conditional code. Slower on average, but the worst case is the only case.
+ *
+ * Results are identical to fast_map().
+ *
+ * The unit tests check on AVR that every input takes exactly the same number of
+ * cycles, within a budget for each intermediate product width (the input & output 
+ * widths added together): see test_fast_map_cycles.cpp & cycle_budgets.h.
+ *
+ * Any 32-bit type needs a 64-bit product, which is computed in 32-bit words: avr-gcc's
+ * 64-bit arithmetic uses library routines with data dependent loops. It is several
+ * times slower than 16-bit types, with a 64 step division.
+ *
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input value
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ * @return TOut
+ */
+template <typename TIn, typename TOut>
+static inline TOut fast_map_constant_time(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    typedef typename fast_map_impl::make_unsigned_t<TIn> in_unsigned_t;
+    typedef typename fast_map_impl::make_unsigned_t<TOut> out_unsigned_t;
+
+    const in_unsigned_t m = fast_map_impl::constantTimeAbsDelta(inMin, in);
+    const in_unsigned_t inRange = fast_map_impl::constantTimeAbsDelta(inMin, inMax);
+    const out_unsigned_t outRange = fast_map_impl::constantTimeAbsDelta(outMin, outMax);
+    typedef decltype(fast_map_impl::safeMultiply(m, outRange)) product_t;
+    const out_unsigned_t scaled = (out_unsigned_t)fast_map_impl::constantTimeMulDiv(m, outRange, inRange, fast_map_impl::product_width_tag<sizeof(product_t)>());
+
+    const bool inOpposite = (in<inMin)!=(inMax<inMin);
+    const out_unsigned_t negate = fast_map_impl::selectMask<out_unsigned_t>(inOpposite!=(outMax<outMin));
+    return (TOut)(outMin + (out_unsigned_t)((scaled ^ negate) - negate));
+}
+
+/**
+ * @brief Map a buffer of values: equivalent to calling fast_map() for each element.
+ * 
+ * All the per-range work is done once, before the loop (see fast_mapper). The loop
+ * is unrolled on AVR & vectorizable elsewhere: see fast_mapper::map_n().
+ * 
+ * @tparam TIn Input range type
+ * @tparam TOut Output range type
+ * @param in Input values
+ * @param out Output values. Can be the same buffer as in (if TIn and TOut are the same type)
+ * @param n Number of values
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ */
+template <typename TIn, typename TOut>
+static inline void fast_map_n(const TIn *in, TOut *out, size_t n, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+    const fast_mapper<TIn, TOut> mapper(inMin, inMax, outMin, outMax);
+    mapper.map_n(in, out, n);
+}
+
+/**
+ * @brief Map a buffer of values in place.
+ * 
+ * @tparam T Input & output range type
+ * @param values Values to map, overwritten with the mapped values
+ * @param n Number of values
+ * @param inMin Input range minimum
+ * @param inMax Input range maximum
+ * @param outMin Output range minimum
+ * @param outMax Output range maximum
+ */
+template <typename T>
+static inline void fast_map_n(T *values, size_t n, T inMin, T inMax, T outMin, T outMax) {
+    fast_map_n((const T*)values, values, n, inMin, inMax, outMin, outMax);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// Maximum AVR cycles allowed for a single fast_map() call, over the worst case
+// inputs & all 4 range directions of test_fast_map_cycles.cpp. Indexed by 
+// [input type][output type].
+//
+// Type order: uint8_t, int8_t, uint16_t, int16_t, uint32_t, int32_t
+//
+// fast_map_constant_time_budget_<N>: maximum AVR cycles for a single 
+// fast_map_constant_time() call, by the width of the intermediate product (input &
+// output type widths added together). Any 32-bit type needs a 64-bit product.
+//
+// The sections between the "cycle_report.py" markers are generated: the measured
+// cycles of each combination plus a small margin. Regenerate them from simulator 
+// test logs (the CYCLES_BUILD row selects the section), E.g.
+//   python cycle_report.py --write O3.log O3-size.log
+//   python cycle_report.py --write Os.log
+// If a change makes a kernel faster, regenerate them to lock the improvement in.
+//
+// Until then they hold per width ceilings, not measured values: estimated from the
+// division loops (one step per quotient bit).
+#if defined(UNOPTIMIZED_BUILD)
+// avr-fast-div disabled: native division
+// cycle_report.py: begin unoptimized
+static const uint16_t fast_map_cycle_budgets[6][6] = {
+    //     u8     s8    u16    s16    u32    s32
+    {  400,   400,  1200,  1200, 12000, 12000 }, // u8
+    {  400,   400,  1200,  1200, 12000, 12000 }, // s8
+    { 1200,  1200,  1200,  1200, 12000, 12000 }, // u16
+    { 1200,  1200,  1200,  1200, 12000, 12000 }, // s16
+    {12000, 12000, 12000, 12000, 12000, 12000 }, // u32
+    {12000, 12000, 12000, 12000, 12000, 12000 }, // s32
+};
+static const uint16_t fast_map_constant_time_budget_16 = 500;
+static const uint16_t fast_map_constant_time_budget_24 = 900;
+static const uint16_t fast_map_constant_time_budget_32 = 1500;
+static const uint16_t fast_map_constant_time_budget_64 = 8000;
+// cycle_report.py: end unoptimized
+#else
+// cycle_report.py: begin optimized
+static const uint16_t fast_map_cycle_budgets[6][6] = {
+    //     u8     s8    u16    s16    u32    s32
+    {  200,   200,   600,   600,  8000,  8000 }, // u8
+    {  200,   200,   600,   600,  8000,  8000 }, // s8
+    {  600,   600,   600,   600,  8000,  8000 }, // u16
+    {  600,   600,   600,   600,  8000,  8000 }, // s16
+    { 8000,  8000,  8000,  8000,  8000,  8000 }, // u32
+    { 8000,  8000,  8000,  8000,  8000,  8000 }, // s32
+};
+static const uint16_t fast_map_constant_time_budget_16 = 500;
+static const uint16_t fast_map_constant_time_budget_24 = 900;
+static const uint16_t fast_map_constant_time_budget_32 = 1500;
+static const uint16_t fast_map_constant_time_budget_64 = 6000;
+// cycle_report.py: end optimized
+#endif
+
+// FAST_MAP_OPTIMIZE_SIZE: every fast_map() call is routed through an out of line
+// kernel. Allow for the call, the register moves to marshal 5 arguments & the
+// offset binary conversion of signed types.
+//
+// An estimate, not measured: cycle_report.py generates it from the test logs of 
+// both build modes.
+#if defined(FAST_MAP_OPTIMIZE_SIZE)
+// cycle_report.py: begin overhead
+static const uint16_t fast_map_call_overhead_budget = 60;
+// cycle_report.py: end overhead
+#else
+static const uint16_t fast_map_call_overhead_budget = 0;
+#endif
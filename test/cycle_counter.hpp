@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <util/atomic.h>
+
+// Count the CPU cycles taken by a function, using Timer1 with no prescaler. 
+// simavr emulates the timer cycle accurately, so this also works in the simulator.
+//
+// Interrupts are disabled during the measurement & the timer configuration
+// is restored afterwards.
+//
+// The timer is 16-bit: measurements saturate at UINT16_MAX. 
+//
+// Note that the measurement includes the cost of starting & stopping the
+// timer plus any loads & stores in fn: subtract the cycles for an "empty" fn
+// to get the net cost.
+template <typename TFn>
+static inline uint16_t measure_cycles(TFn fn) {
+    uint16_t cycles;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint8_t savedTccr1a = TCCR1A;
+        const uint8_t savedTccr1b = TCCR1B;
+        const uint16_t savedTcnt1 = TCNT1;
+
+        TCCR1B = 0;
+        TCCR1A = 0;
+        TCNT1 = 0;
+        TIFR1 = _BV(TOV1);
+        TCCR1B = _BV(CS10);
+        fn();
+        TCCR1B = 0;
+        cycles = TCNT1;
+        if (TIFR1 & _BV(TOV1)) {
+            cycles = UINT16_MAX;
+        }
+
+        TCNT1 = savedTcnt1;
+        TCCR1A = savedTccr1a;
+        TCCR1B = savedTccr1b;
+    }
+    return cycles;
+}
+
+#define CYCLE_COUNTER_AVAILABLE
+#endif
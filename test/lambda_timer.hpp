@@ -15,6 +15,16 @@ void measure_executiontime(uint16_t iterations, TLoop from, TLoop to, TLoop step
     measure.stop();
 }
 
+template <typename TParam>
+void measure_executiontime(uint16_t iterations, simple_timer_t &measure, TParam param, void (*pTestFun)(TParam)) {
+    measure.start();
+    for (uint16_t loop=0; loop<iterations; ++loop)
+    {
+      pTestFun(param);
+    }
+    measure.stop();
+}
+
 template <typename TParam>
 struct execution_time {
     TParam result;
@@ -56,6 +66,23 @@ comparative_execution_times<TParam> compare_executiontime(TLoop from, TLoop to,
     TParam paramB = 0;
     measure_executiontime<TLoop, TParam&>(1U, from, to, step, timerB, paramB, pTestFunB);
 
+    return comparative_execution_times<TParam> {
+        .timeA = execution_time<TParam> { .result = paramA, .timer = timerA },
+        .timeB = execution_time<TParam> { .result = paramB, .timer = timerB }
+    };
+}
+
+template <typename TParam>
+comparative_execution_times<TParam> compare_executiontime(uint16_t iterations, void (*pTestFunA)(TParam&), void (*pTestFunB)(TParam&)) {
+
+    simple_timer_t timerA;
+    TParam paramA = 0;
+    measure_executiontime<TParam&>(iterations, timerA, paramA, pTestFunA);
+
+    simple_timer_t timerB;
+    TParam paramB = 0;
+    measure_executiontime<TParam&>(iterations, timerB, paramB, pTestFunB);
+
     return comparative_execution_times<TParam> {
         .timeA = execution_time<TParam> { .result = paramA, .timer = timerA },
         .timeB = execution_time<TParam> { .result = paramB, .timer = timerB }
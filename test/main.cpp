@@ -1,10 +1,45 @@
 #include <Arduino.h>
 #include <unity.h>
+#if defined(SIMULATOR)
 #include <avr/sleep.h>
+#endif
 
 void test_fast_map_implementation(void);
 void test_fast_map(void) ;
 void test_fast_map_perf(void);
+void test_fast_map_lut(void);
+void test_fast_map_curve(void);
+void test_fast_map_table2d(void);
+void test_fast_map_iterator(void);
+void test_fast_map_cached(void);
+void test_fast_map_shared(void);
+void test_fast_map_compose(void);
+void test_fast_map_bank(void);
+void test_fast_map_float(void);
+void test_fast_map_flash(void);
+void test_fast_map_cycles(void);
+
+static int run_tests(void)
+{
+    UNITY_BEGIN(); 
+    test_fast_map_implementation();
+    test_fast_map();
+    test_fast_map_lut();
+    test_fast_map_curve();
+    test_fast_map_table2d();
+    test_fast_map_iterator();
+    test_fast_map_cached();
+    test_fast_map_shared();
+    test_fast_map_compose();
+    test_fast_map_bank();
+    test_fast_map_float();
+    test_fast_map_flash();
+    test_fast_map_perf();
+    test_fast_map_cycles();
+    return UNITY_END(); 
+}
+
+#if defined(ARDUINO)
 
 void setup()
 {
@@ -22,11 +57,7 @@ void setup()
     Serial.println("");
 #endif
 
-    UNITY_BEGIN(); 
-    test_fast_map_implementation();
-    test_fast_map();
-    test_fast_map_perf();
-    UNITY_END(); 
+    run_tests();
     
 #if defined(SIMULATOR)
     // Tell SimAVR we are done
@@ -43,4 +74,14 @@ void loop()
     delay(250);
     digitalWrite(LED_BUILTIN, LOW);
     delay(250);
-}
\ No newline at end of file
+}
+
+#else
+
+// Native (host) build: there is no Arduino runtime to call setup()
+int main(void)
+{
+    return run_tests();
+}
+
+#endif
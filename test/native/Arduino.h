@@ -0,0 +1,15 @@
+#pragma once
+
+// The subset of the Arduino API used by the unit tests, for the native 
+// (host) build. The library itself does not need this.
+
+#include <stdint.h>
+#include <stdio.h>
+
+static inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
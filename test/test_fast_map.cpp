@@ -11,6 +11,8 @@ static void assert_fast_map(T in, T inMin, T inMax, U outMin, U outMax) {
     sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
     (int32_t)in, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
     TEST_ASSERT_EQUAL_MESSAGE(expected, actual, szMsg);  
+    const fast_mapper<T, U> mapper(inMin, inMax, outMin, outMax);
+    TEST_ASSERT_EQUAL_MESSAGE(expected, mapper.map(in), szMsg);  
 }
 
 template <typename T, typename U>
@@ -138,6 +140,551 @@ static void test_maths_fastMap_S16xS16_above_range(void)
     assert_fast_map(in, inMin, inMax, outMin, outMax);
 }
 
+template <typename T, typename U>
+static void assert_fast_mapper(const fast_mapper<T, U> &mapper, T in, T inMin, T inMax, U outMin, U outMax) {
+    U expected = (U)map(in, inMin, inMax, outMin, outMax);
+    char szMsg[256];
+    sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+    (int32_t)in, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
+    TEST_ASSERT_EQUAL_MESSAGE(expected, mapper.map(in), szMsg);  
+}
+
+static void test_maths_fastMapper_U8xU8_all_inputs(void)
+{
+    // Every input (including those outside the input range) for a spread of 
+    // input & output ranges, both directions
+    for (uint16_t inRange = 1; inRange <= UINT8_MAX; inRange = (uint16_t)(inRange + 7U))
+    {
+      for (uint16_t outRange = 0; outRange <= UINT8_MAX; outRange = (uint16_t)(outRange + 13U))
+      {
+        const uint8_t inMin = (uint8_t)((UINT8_MAX - inRange) / 2U);
+        const uint8_t inMax = (uint8_t)(inMin + inRange);
+        const uint8_t outMin = (uint8_t)(UINT8_MAX - outRange);
+        const uint8_t outMax = UINT8_MAX;
+        const fast_mapper<uint8_t, uint8_t> normal(inMin, inMax, outMin, outMax);
+        const fast_mapper<uint8_t, uint8_t> inverted(inMax, inMin, outMin, outMax);
+        for (uint16_t in = 0; in <= UINT8_MAX; ++in)
+        {
+          assert_fast_mapper(normal, (uint8_t)in, inMin, inMax, outMin, outMax);
+          assert_fast_mapper(inverted, (uint8_t)in, inMax, inMin, outMin, outMax);
+        }
+      }
+    }
+}
+
+static void test_maths_fastMapper_S16xS16(void)
+{
+    const int16_t inMin = -1500;
+    const int16_t inMax = 11123;
+    const int16_t outMin = 1200;
+    const int16_t outMax = -5000;    
+    const fast_mapper<int16_t, int16_t> mapper(inMin, inMax, outMin, outMax);
+
+    for (int32_t in = -15000; in <= 15000; in = in + 7)
+    {
+      assert_fast_mapper(mapper, (int16_t)in, inMin, inMax, outMin, outMax);
+    }
+}
+
+static void test_maths_fastMapper_U16xU8(void)
+{
+    // Compressing ADC style range
+    const uint16_t inMin = 0;
+    const uint16_t inMax = 1023;
+    const uint8_t outMin = 0;
+    const uint8_t outMax = 255;    
+    const fast_mapper<uint16_t, uint8_t> mapper(inMin, inMax, outMin, outMax);
+
+    for (uint16_t in = inMin; in <= inMax; ++in)
+    {
+      assert_fast_mapper(mapper, in, inMin, inMax, outMin, outMax);
+    }
+}
+
+template <int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax, typename T>
+static void test_const_fast_map(T from, T to)
+{
+    typedef fast_map_impl::narrowest_integral_t<outMin, outMax> U;
+    for (int32_t in = from; in <= to; ++in)
+    {
+      U expected = (U)map(in, inMin, inMax, outMin, outMax);
+      char szMsg[256];
+      sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+        in, inMin, inMax, outMin, outMax);
+      TEST_ASSERT_EQUAL_MESSAGE(expected, (fast_map<inMin, inMax, outMin, outMax>((T)in)), szMsg);  
+    }
+}
+
+static void test_maths_constFastMap_add_only(void)
+{
+    test_const_fast_map<100, 355, -20, 235>((int16_t)0, (int16_t)500);
+    test_const_fast_map<355, 100, -20, 235>((int16_t)0, (int16_t)500);
+    test_const_fast_map<0, 255, 0, 255>((uint8_t)0, (uint8_t)UINT8_MAX);
+    test_const_fast_map<0, 255, 255, 0>((uint8_t)0, (uint8_t)UINT8_MAX);
+}
+
+static void test_maths_constFastMap_shift(void)
+{
+    test_const_fast_map<0, 1024, 0, 100>((uint16_t)0, (uint16_t)2048);
+    test_const_fast_map<1024, 0, 0, 100>((uint16_t)0, (uint16_t)2048);
+    test_const_fast_map<-64, 64, 1000, -3000>((int8_t)INT8_MIN, (int8_t)INT8_MAX);
+    test_const_fast_map<10, 11, 0, 200>((uint8_t)0, (uint8_t)UINT8_MAX);
+    // 16-bit product within the range, 32-bit outside
+    test_const_fast_map<0, 256, 0, 200>((uint16_t)0, (uint16_t)4096);
+    test_const_fast_map<256, 0, 200, 0>((uint16_t)0, (uint16_t)4096);
+}
+
+static void test_maths_constFastMap_reciprocal(void)
+{
+    test_const_fast_map<0, 1023, 0, 255>((uint16_t)0, (uint16_t)2048);
+    test_const_fast_map<0, 1023, 255, 0>((uint16_t)0, (uint16_t)2048);
+    test_const_fast_map<3, 233, 0, 255>((uint8_t)0, (uint8_t)UINT8_MAX);
+    test_const_fast_map<-1500, -11123, 1200, 5000>((int16_t)-15000, (int16_t)3000);
+    test_const_fast_map<1521, 53333, 13107, 19659>((uint16_t)0, (uint16_t)UINT16_MAX);
+}
+
+static void test_maths_fastMapN_S16xU8(void)
+{
+    const int16_t inMin = -1500;
+    const int16_t inMax = 11123;
+    const uint8_t outMin = 250;
+    const uint8_t outMax = 10;    
+    int16_t in[37];
+    uint8_t out[sizeof(in)/sizeof(in[0])];
+    for (uint8_t i = 0; i < sizeof(in)/sizeof(in[0]); ++i)
+    {
+      in[i] = (int16_t)(inMin + (i * 331));
+    }
+    // Out of range inputs, in the first block & the unrolled loop remainder
+    in[3] = -2000;
+    in[35] = 12000;
+
+    // Check all lengths, to cover the unrolled loop remainder
+    for (uint8_t n = 0; n <= sizeof(in)/sizeof(in[0]); ++n)
+    {
+      memset(out, 0, sizeof(out));
+      fast_map_n(in, out, n, inMin, inMax, outMin, outMax);
+      for (uint8_t i = 0; i < sizeof(in)/sizeof(in[0]); ++i)
+      {
+        uint8_t expected = i<n ? (uint8_t)map(in[i], inMin, inMax, outMin, outMax) : 0;
+        TEST_ASSERT_EQUAL_UINT8(expected, out[i]);
+      }
+    }
+}
+
+static void test_maths_fastMapN_in_place(void)
+{
+    const uint16_t inMin = 0;
+    const uint16_t inMax = 1023;
+    const uint16_t outMin = 1000;
+    const uint16_t outMax = 5000;    
+    uint16_t values[67];
+    for (uint8_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+    {
+      values[i] = (uint16_t)(i * 31U);
+    }
+
+    // Includes out of range inputs
+    fast_map_n(values, sizeof(values)/sizeof(values[0]), inMin, inMax, outMin, outMax);
+
+    for (uint8_t i = 0; i < sizeof(values)/sizeof(values[0]); ++i)
+    {
+      TEST_ASSERT_EQUAL_UINT16(map(i * 31U, inMin, inMax, outMin, outMax), values[i]);
+    }
+}
+
+template <typename T, typename U>
+static void test_fast_map_constrain(T inMin, T inMax, U outMin, U outMax, int32_t from, int32_t to, int32_t step)
+{
+    const int32_t inLow = min(inMin, inMax);
+    const int32_t inHigh = max(inMin, inMax);
+    const int32_t inRange = inHigh - inLow;
+    for (int32_t in = from; in <= to; in = in + step)
+    {
+      char szMsg[256];
+      sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+        in, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
+
+      TEST_ASSERT_EQUAL_MESSAGE((U)map(in, inMin, inMax, outMin, outMax), 
+                                fast_map_constrain<fast_map_mode::extrapolate>((T)in, inMin, inMax, outMin, outMax), szMsg);
+
+      U expected = (U)constrain(map(in, inMin, inMax, outMin, outMax), min(outMin, outMax), max(outMin, outMax));
+      TEST_ASSERT_EQUAL_MESSAGE(expected, fast_map_constrain((T)in, inMin, inMax, outMin, outMax), szMsg);
+
+      // Wrapping is relative to inMin, in the direction of inMax
+      int32_t wrapped = in;
+      if (in<inLow || in>inHigh) {
+        int32_t offset = ((in - inMin) * (inMax<inMin ? -1 : 1)) % inRange;
+        if (offset<0) { offset = offset + inRange; }
+        wrapped = inMin + (offset * (inMax<inMin ? -1 : 1));
+      }
+      TEST_ASSERT_EQUAL_MESSAGE((U)map(wrapped, inMin, inMax, outMin, outMax), 
+                                fast_map_constrain<fast_map_mode::wrap>((T)in, inMin, inMax, outMin, outMax), szMsg);
+    }
+}
+
+static void test_maths_fastMapConstrain_U8xU8(void)
+{
+    test_fast_map_constrain<uint8_t, uint8_t>(30, 200, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_map_constrain<uint8_t, uint8_t>(200, 30, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_map_constrain<uint8_t, uint8_t>(30, 200, 250, 10, 0, UINT8_MAX, 1);
+    test_fast_map_constrain<uint8_t, uint8_t>(200, 30, 250, 10, 0, UINT8_MAX, 1);
+}
+
+static void test_maths_fastMapConstrain_S16xS16(void)
+{
+    test_fast_map_constrain<int16_t, int16_t>(-1500, 11123, 1200, -5000, INT16_MIN, INT16_MAX, 7);
+    test_fast_map_constrain<int16_t, int16_t>(11123, -1500, 1200, -5000, INT16_MIN, INT16_MAX, 7);
+    test_fast_map_constrain<int16_t, int16_t>(0, 360, 0, 1000, -1080, 1080, 1);
+}
+
+template <typename T, typename U>
+static void test_fast_map_round_fixed(T inMin, T inMax, U outMin, U outMax, int32_t from, int32_t to, int32_t step)
+{
+    const int64_t inDelta = (int64_t)inMax - inMin;
+    const int64_t outDelta = (int64_t)outMax - outMin;
+    for (int32_t in = from; in <= to; in = in + step)
+    {
+      char szMsg[256];
+      sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+        in, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
+
+      // Round half away from outMin
+      const int64_t numerator = (in - (int64_t)inMin) * outDelta;
+      const int64_t magnitude = ((numerator<0 ? -numerator : numerator) * 2 + (inDelta<0 ? -inDelta : inDelta)) / (2 * (inDelta<0 ? -inDelta : inDelta));
+      const int64_t rounded = ((numerator<0)!=(inDelta<0)) ? outMin - magnitude : outMin + magnitude;
+      TEST_ASSERT_EQUAL_MESSAGE((U)rounded, fast_map_round((T)in, inMin, inMax, outMin, outMax), szMsg);
+
+      // Same as map() with a scaled output range
+      typedef fast_map_impl::widen_integral_t<U> fixed_t;
+      const uint8_t fracBits = sizeof(U)*8U;
+      const int64_t fixed = (((int64_t)in - inMin) * (outDelta * ((int64_t)1 << fracBits)) / inDelta) + ((int64_t)outMin * ((int64_t)1 << fracBits));
+      TEST_ASSERT_EQUAL_MESSAGE((fixed_t)fixed, fast_map_fixed((T)in, inMin, inMax, outMin, outMax), szMsg);
+      const int64_t fixed4 = (((int64_t)in - inMin) * (outDelta * 16) / inDelta) + ((int64_t)outMin * 16);
+      TEST_ASSERT_EQUAL_MESSAGE((fixed_t)fixed4, fast_map_fixed<4>((T)in, inMin, inMax, outMin, outMax), szMsg);
+    }
+}
+
+static void test_maths_fastMapRoundFixed_U8xU8(void)
+{
+    test_fast_map_round_fixed<uint8_t, uint8_t>(30, 200, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_map_round_fixed<uint8_t, uint8_t>(200, 30, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_map_round_fixed<uint8_t, uint8_t>(0, 255, 100, 0, 0, UINT8_MAX, 1);
+    test_fast_map_round_fixed<uint8_t, uint8_t>(0, 4, 0, 10, 0, UINT8_MAX, 1);
+}
+
+static void test_maths_fastMapRoundFixed_S16xS16(void)
+{
+    test_fast_map_round_fixed<int16_t, int16_t>(-1500, 11123, 1200, -5000, -11000, 15000, 7);
+    test_fast_map_round_fixed<int16_t, int16_t>(11123, -1500, 1200, -5000, -11000, 15000, 7);
+}
+
+static void test_maths_fastMapRoundFixed_U16xU8(void)
+{
+    test_fast_map_round_fixed<uint16_t, uint8_t>(0, 1023, 0, 100, 0, 1023, 1);
+    test_fast_map_round_fixed<uint16_t, uint8_t>(0, 1000, 100, 0, 0, 1200, 1);
+}
+
+static void test_maths_fastMapFixed_32bitOut(void)
+{
+    // The dividend of the default Q32.32 result is wider than 64 bits
+    TEST_ASSERT_EQUAL_UINT64(13474407203137254901ULL, fast_map_fixed((uint8_t)200, (uint8_t)0, (uint8_t)255, (uint32_t)0, (uint32_t)4000000000UL));
+    TEST_ASSERT_EQUAL_UINT64(17179869184000000000ULL, fast_map_fixed((uint8_t)255, (uint8_t)0, (uint8_t)255, (uint32_t)0, (uint32_t)4000000000UL));
+    TEST_ASSERT_EQUAL_INT64(2767011608264704000LL, fast_map_fixed((int16_t)-300, (int16_t)-1000, (int16_t)1000, (int32_t)INT32_MAX, (int32_t)INT32_MIN));
+    // Same as fewer fractional bits (for ascending ranges)
+    for (uint16_t in = 0; in <= 1023U; ++in)
+    {
+      const uint64_t fixed16 = (((uint64_t)in * 3000000000ULL) << 16U) / 1023U;
+      TEST_ASSERT_EQUAL_UINT64(fixed16, fast_map_fixed<16>(in, (uint16_t)0, (uint16_t)1023, (uint32_t)0, (uint32_t)3000000000UL));
+      TEST_ASSERT_EQUAL_UINT64(fixed16, fast_map_fixed(in, (uint16_t)0, (uint16_t)1023, (uint32_t)0, (uint32_t)3000000000UL) >> 16U);
+    }
+}
+
+template <typename T, typename U>
+static void test_fast_unmap(T inMin, T inMax, U outMin, U outMax, int32_t from, int32_t to, int32_t step)
+{
+    const fast_bimapper<T, U> mapper(inMin, inMax, outMin, outMax);
+    const int64_t inDelta = (int64_t)inMax - inMin;
+    const int64_t outDelta = (int64_t)outMax - outMin;
+    for (int32_t out = from; out <= to; out = out + step)
+    {
+      char szMsg[256];
+      sprintf(szMsg, "Out %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+        out, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
+
+      // Round away from inMin
+      const int64_t numerator = (out - (int64_t)outMin) * inDelta;
+      const int64_t absOutDelta = outDelta<0 ? -outDelta : outDelta;
+      const int64_t magnitude = ((numerator<0 ? -numerator : numerator) + absOutDelta - 1) / absOutDelta;
+      const int64_t expected = ((numerator<0)!=(outDelta<0)) ? inMin - magnitude : inMin + magnitude;
+      TEST_ASSERT_EQUAL_MESSAGE((T)expected, fast_unmap((U)out, inMin, inMax, outMin, outMax), szMsg);
+      TEST_ASSERT_EQUAL_MESSAGE((T)expected, mapper.unmap((U)out), szMsg);
+    }
+}
+
+template <typename T, typename U>
+static void test_fast_unmap_round_trip(T inMin, T inMax, U outMin, U outMax)
+{
+    const fast_bimapper<T, U> mapper(inMin, inMax, outMin, outMax);
+    const bool expanding = fast_map_impl::absDelta(outMin, outMax)>=fast_map_impl::absDelta(inMin, inMax);
+    for (int32_t in = min(inMin, inMax); in <= max(inMin, inMax); ++in)
+    {
+      const U out = mapper.map((T)in);
+      const T back = mapper.unmap(out);
+      if (expanding) {
+        TEST_ASSERT_EQUAL((T)in, back);
+      } else {
+        TEST_ASSERT_EQUAL(out, mapper.map(back));
+      }
+    }
+}
+
+static void test_maths_fastUnmap_U8xU8(void)
+{
+    test_fast_unmap<uint8_t, uint8_t>(30, 200, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_unmap<uint8_t, uint8_t>(200, 30, 10, 250, 0, UINT8_MAX, 1);
+    test_fast_unmap<uint8_t, uint8_t>(0, 255, 100, 0, 0, UINT8_MAX, 1);
+    test_fast_unmap<uint8_t, uint8_t>(0, 250, 0, 4, 0, 4, 1);
+    test_fast_unmap_round_trip<uint8_t, uint8_t>(30, 200, 10, 250);
+    test_fast_unmap_round_trip<uint8_t, uint8_t>(0, 255, 100, 0);
+}
+
+static void test_maths_fastUnmap_S16xS16(void)
+{
+    test_fast_unmap<int16_t, int16_t>(-1500, 11123, 1200, -5000, -11000, 15000, 7);
+    test_fast_unmap<int16_t, int16_t>(11123, -1500, -5000, 1200, -11000, 15000, 7);
+    test_fast_unmap_round_trip<int16_t, int16_t>(-1500, 1123, 1200, -5000);
+    test_fast_unmap_round_trip<int16_t, int16_t>(-1500, 11123, 12, -50);
+}
+
+static void test_maths_fastUnmap_U16xU8(void)
+{
+    test_fast_unmap<uint16_t, uint8_t>(0, 1023, 0, 100, 0, UINT8_MAX, 1);
+    test_fast_unmap<uint16_t, uint8_t>(1000, 0, 0, 255, 0, UINT8_MAX, 1);
+    test_fast_unmap_round_trip<uint16_t, uint8_t>(0, 1023, 0, 100);
+    test_fast_unmap_round_trip<uint16_t, uint8_t>(0, 200, 255, 0);
+}
+
+// The exact mean: the same as map() over the input range multiplied by the count
+template <typename TSum, typename TIn, typename TOut>
+static void test_fast_map_accumulated(uint8_t count, TIn inMin, TIn inMax, TOut outMin, TOut outMax, int32_t from, int32_t to, int32_t step)
+{
+    for (int32_t sum = from; sum <= to; sum += step)
+    {
+      const TOut expected = (TOut)map(sum, (int32_t)count*inMin, (int32_t)count*inMax, outMin, outMax);
+      char szMsg[64];
+      sprintf(szMsg, "Sum %" PRId32 ", count %u", sum, (unsigned)count);
+      TEST_ASSERT_EQUAL_MESSAGE(expected, fast_map_accumulated((TSum)sum, count, inMin, inMax, outMin, outMax), szMsg);
+      if (sum % count == 0)
+      {
+        // Whole number mean
+        TEST_ASSERT_EQUAL_MESSAGE(fast_map((TIn)(sum/count), inMin, inMax, outMin, outMax), 
+                                  fast_map_accumulated((TSum)sum, count, inMin, inMax, outMin, outMax), szMsg);
+      }
+    }
+}
+
+static void test_maths_fastMapAccumulated(void)
+{
+    // Oversampled 10-bit ADC
+    const uint8_t counts[] = { 1, 4, 10, 16, 63 };
+    for (uint8_t index = 0; index < sizeof(counts); ++index)
+    {
+      const uint8_t count = counts[index];
+      test_fast_map_accumulated<uint16_t, uint16_t, uint8_t>(count, 0, 1023, 0, 100, 0, (int32_t)count*1023, 1);
+      test_fast_map_accumulated<uint16_t, uint16_t, int16_t>(count, 1000, 100, -500, 3000, 0, (int32_t)count*1023, 3);
+    }
+    // Signed samples & out of range sums
+    test_fast_map_accumulated<int16_t, int8_t, int16_t>(8, -100, 100, 1000, -1000, -1024, 1016, 1);
+    test_fast_map_accumulated<int32_t, int16_t, uint8_t>(200, -20000, 20000, 0, 255, -4000000L, 4000000L, 997);
+
+    // Constant count. The output reaches 50 at a mean of 511.5: averaging first
+    // (511) would give 49
+    TEST_ASSERT_EQUAL_UINT8(50, fast_map_accumulated<16>((uint16_t)(511U*16U+8U), (uint16_t)0, (uint16_t)1023, (uint8_t)0, (uint8_t)100));
+    TEST_ASSERT_EQUAL_UINT8(49, fast_map_accumulated<16>((uint16_t)(511U*16U+7U), (uint16_t)0, (uint16_t)1023, (uint8_t)0, (uint8_t)100));
+}
+
+// The exhaustive tests below make too many calls to format a message for each one:
+// only failures are reported in detail.
+template <typename T, typename U>
+static void check_fast_map(T in, T inMin, T inMax, U outMin, U outMax) {
+    if (fast_map(in, inMin, inMax, outMin, outMax)!=(U)map(in, inMin, inMax, outMin, outMax)) {
+      assert_fast_map(in, inMin, inMax, outMin, outMax);
+    }
+}
+
+// Every 8x8 kernel input (a=in-inMin, divisor=inRange): in & out of range
+static void test_maths_fastMap_U8xU8_exhaustive(void)
+{
+    for (uint16_t inMax = 1; inMax <= UINT8_MAX; ++inMax)
+    {
+      for (uint16_t in = 0; in <= UINT8_MAX; ++in)
+      {
+        check_fast_map((uint8_t)in, (uint8_t)0, (uint8_t)inMax, (uint8_t)0, (uint8_t)UINT8_MAX);
+        check_fast_map((uint8_t)in, (uint8_t)0, (uint8_t)inMax, (uint8_t)200, (uint8_t)100);
+        check_fast_map((uint8_t)in, (uint8_t)inMax, (uint8_t)0, (uint8_t)7, (uint8_t)8);
+      }
+    }
+}
+
+// Every 16-bit input, for 8-bit outputs
+static void test_maths_fastMap_U16xU8_exhaustive(void)
+{
+    uint16_t in = 0;
+    do
+    {
+      check_fast_map(in, (uint16_t)0, (uint16_t)1023, (uint8_t)0, (uint8_t)100);
+      check_fast_map(in, (uint16_t)UINT16_MAX, (uint16_t)0, (uint8_t)0, (uint8_t)UINT8_MAX);
+      check_fast_map(in, (uint16_t)1000, (uint16_t)5000, (uint8_t)255, (uint8_t)3);
+      ++in;
+    } while (in!=0U);
+}
+
+// Every 8-bit input & input range, for 16-bit outputs
+static void test_maths_fastMap_U8xU16_exhaustive(void)
+{
+    for (uint16_t inMax = 1; inMax <= UINT8_MAX; ++inMax)
+    {
+      for (uint16_t in = 0; in <= UINT8_MAX; ++in)
+      {
+        check_fast_map((uint8_t)in, (uint8_t)0, (uint8_t)inMax, (uint16_t)0, (uint16_t)UINT16_MAX);
+        check_fast_map((uint8_t)in, (uint8_t)inMax, (uint8_t)0, (uint16_t)1000, (uint16_t)0);
+      }
+    }
+}
+
+// Checked with a multiply, not a division, to keep the run time down
+static void check_mulDiv_U8xU8(uint8_t a, uint8_t b, uint8_t divisor) {
+    const uint16_t product = (uint16_t)(a * b);
+    const uint16_t quotient = fast_map_impl::mulDiv(a, b, divisor);
+    const uint16_t lower = (uint16_t)(quotient * divisor);
+    if (lower>product || (uint16_t)(product - lower)>=divisor) {
+      char szMsg[64];
+      sprintf(szMsg, "a %u, b %u, divisor %u", (unsigned)a, (unsigned)b, (unsigned)divisor);
+      TEST_ASSERT_EQUAL_UINT16_MESSAGE(product / divisor, quotient, szMsg);
+    }
+}
+
+// The 8x8 mulDiv() kernel (inline assembly on AVR) for every multiplier & divisor 
+// pair: every in range a (a<=divisor), plus the largest out of range a.
+static void test_maths_mulDiv_U8xU8_exhaustive(void)
+{
+    for (uint16_t divisor = 1; divisor <= UINT8_MAX; ++divisor)
+    {
+      for (uint16_t b = 0; b <= UINT8_MAX; ++b)
+      {
+        for (uint16_t a = 0; a <= divisor; ++a)
+        {
+          check_mulDiv_U8xU8((uint8_t)a, (uint8_t)b, (uint8_t)divisor);
+        }
+        check_mulDiv_U8xU8(UINT8_MAX, (uint8_t)b, (uint8_t)divisor);
+      }
+    }
+}
+
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+// Every divisor in the reciprocal table: every input for 8-bit input ranges, 
+// an even sample above that. Plus the first out of range input (no table).
+static void test_maths_fastMap_reciprocal_lut_exhaustive(void)
+{
+    for (uint16_t inMax = 1; inMax <= FAST_MAP_RECIPROCAL_LUT; ++inMax)
+    {
+      const uint16_t step = (uint16_t)(inMax/64U + 1U);
+      for (uint16_t in = 0; in <= inMax; in = (uint16_t)(in + step))
+      {
+        check_fast_map(in, (uint16_t)0, inMax, (uint8_t)0, (uint8_t)UINT8_MAX);
+        check_fast_map(in, inMax, (uint16_t)0, (uint16_t)UINT16_MAX, (uint16_t)0);
+        check_fast_map(in, (uint16_t)0, inMax, (int16_t)-1000, (int16_t)1001);
+      }
+      check_fast_map(inMax, (uint16_t)0, inMax, (uint16_t)0, (uint16_t)UINT16_MAX);
+      check_fast_map((uint16_t)(inMax-1U), (uint16_t)0, inMax, (uint16_t)0, (uint16_t)UINT16_MAX);
+      check_fast_map((uint16_t)(inMax+1U), (uint16_t)0, inMax, (uint8_t)0, (uint8_t)UINT8_MAX);
+    }
+}
+#endif
+
+template <typename T, typename U>
+static void assert_fast_map_constant_time(T in, T inMin, T inMax, U outMin, U outMax) {
+    // fast_map() is the reference: map() overflows for wide 32-bit ranges
+    const U expected = fast_map(in, inMin, inMax, outMin, outMax);
+    const U actual = fast_map_constant_time(in, inMin, inMax, outMin, outMax);
+    if (expected!=actual) {
+      char szMsg[256];
+      sprintf(szMsg, "In %" PRId32 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+      (int32_t)in, (int32_t)inMin, (int32_t)inMax, (int32_t)outMin, (int32_t)outMax);
+      TEST_ASSERT_EQUAL_MESSAGE(expected, actual, szMsg);
+    }
+}
+
+static void test_maths_fastMapConstantTime(void)
+{
+    for (uint16_t inMax = 1; inMax <= UINT8_MAX; inMax += 7)
+    {
+      for (uint16_t in = 0; in <= UINT8_MAX; ++in)
+      {
+        assert_fast_map_constant_time((uint8_t)in, (uint8_t)0, (uint8_t)inMax, (uint8_t)0, (uint8_t)UINT8_MAX);
+        assert_fast_map_constant_time((uint8_t)in, (uint8_t)inMax, (uint8_t)3, (uint8_t)200, (uint8_t)100);
+        assert_fast_map_constant_time((int8_t)in, (int8_t)-100, (int8_t)inMax, (int16_t)-23579, (int16_t)-15973);
+      }
+    }
+    for (int32_t in = INT16_MIN; in <= INT16_MAX; in += 61)
+    {
+      assert_fast_map_constant_time((int16_t)in, (int16_t)-1500, (int16_t)-11123, (int16_t)1200, (int16_t)5000);
+      assert_fast_map_constant_time((uint16_t)in, (uint16_t)0, (uint16_t)1023, (uint8_t)0, (uint8_t)100);
+      assert_fast_map_constant_time((uint16_t)in, (uint16_t)UINT16_MAX, (uint16_t)0, (int32_t)-2000000000L, (int32_t)2000000000L);
+    }
+    for (uint32_t in = 0; in <= 4000000000UL; in += 39999991UL)
+    {
+      assert_fast_map_constant_time(in, (uint32_t)5, (uint32_t)4000000000UL, (uint32_t)4000000000UL, (uint32_t)5);
+      assert_fast_map_constant_time((int32_t)in, (int32_t)-2000000000L, (int32_t)2000000000L, (int8_t)-100, (int8_t)110);
+    }
+}
+
+// 64-bit products are computed in 32-bit words: random full width ranges, including
+// inputs outside the range & divisors with the top bit set
+static void test_maths_fastMapConstantTime_32bit(void)
+{
+    uint32_t state = 12345UL;
+    for (uint16_t index = 0; index < 5000U; ++index)
+    {
+      uint32_t values[5];
+      for (uint8_t value = 0; value < 5U; ++value)
+      {
+        state = (uint32_t)((state * 1664525UL) + 1013904223UL);
+        values[value] = state;
+      }
+      assert_fast_map_constant_time(values[0], values[1], values[2], values[3], values[4]);
+      assert_fast_map_constant_time((int32_t)values[0], (int32_t)values[1], (int32_t)values[2], (int32_t)values[3], (int32_t)values[4]);
+      assert_fast_map_constant_time((uint16_t)values[0], (uint16_t)values[1], (uint16_t)values[2], values[3], values[4]);
+      assert_fast_map_constant_time((int32_t)values[0], (int32_t)values[1], (int32_t)values[2], (int8_t)values[3], (int8_t)values[4]);
+    }
+    assert_fast_map_constant_time(UINT32_MAX, (uint32_t)0, UINT32_MAX, UINT32_MAX, (uint32_t)0);
+    assert_fast_map_constant_time((uint32_t)1, (uint32_t)0, UINT32_MAX, (uint32_t)0, UINT32_MAX);
+    assert_fast_map_constant_time(INT32_MIN, INT32_MAX, INT32_MIN, INT32_MIN, INT32_MAX);
+}
+
+#if defined(FAST_MAP_INT24)
+static void test_maths_fastMap_24bit(void)
+{
+    // 24-bit inputs
+    for (int32_t in = 0; in <= 16000000L; in += 99991L)
+    {
+      assert_fast_map((__uint24)in, (__uint24)0UL, (__uint24)16000000UL, (uint8_t)0, (uint8_t)100);
+      assert_fast_map((__uint24)in, (__uint24)16000000UL, (__uint24)0UL, (uint8_t)0, (uint8_t)100);
+    }
+    for (int32_t in = -8000000L; in <= 8000000L; in += 99991L)
+    {
+      assert_fast_map((__int24)in, (__int24)-8000000L, (__int24)8000000L, (int8_t)50, (int8_t)-50);
+    }
+    // 24-bit outputs
+    for (uint16_t in = 0; in <= 1000U; ++in)
+    {
+      assert_fast_map(in, (uint16_t)0U, (uint16_t)1000U, (__uint24)100000UL, (__uint24)2100000UL);
+      assert_fast_map((int16_t)in, (int16_t)1000, (int16_t)0, (__int24)-1000000L, (__int24)1000000L);
+    }
+}
+#endif
+
 void test_fast_map(void) {
   SET_UNITY_FILENAME() {
     RUN_TEST(test_maths_fastMap_U16xU16_same_direction);
@@ -146,5 +693,35 @@ void test_fast_map(void) {
     RUN_TEST(test_maths_fastMap_S8xS16_different_direction);
     RUN_TEST(test_maths_fastMap_S16xS16_below_range);
     RUN_TEST(test_maths_fastMap_S16xS16_above_range);
+    RUN_TEST(test_maths_fastMapper_U8xU8_all_inputs);
+    RUN_TEST(test_maths_fastMapper_S16xS16);
+    RUN_TEST(test_maths_fastMapper_U16xU8);
+    RUN_TEST(test_maths_constFastMap_add_only);
+    RUN_TEST(test_maths_constFastMap_shift);
+    RUN_TEST(test_maths_constFastMap_reciprocal);
+    RUN_TEST(test_maths_fastMapN_S16xU8);
+    RUN_TEST(test_maths_fastMapN_in_place);
+    RUN_TEST(test_maths_fastMapConstrain_U8xU8);
+    RUN_TEST(test_maths_fastMapConstrain_S16xS16);
+    RUN_TEST(test_maths_fastMapRoundFixed_U8xU8);
+    RUN_TEST(test_maths_fastMapRoundFixed_S16xS16);
+    RUN_TEST(test_maths_fastMapRoundFixed_U16xU8);
+    RUN_TEST(test_maths_fastMapFixed_32bitOut);
+    RUN_TEST(test_maths_fastUnmap_U8xU8);
+    RUN_TEST(test_maths_fastUnmap_S16xS16);
+    RUN_TEST(test_maths_fastUnmap_U16xU8);
+    RUN_TEST(test_maths_fastMapAccumulated);
+    RUN_TEST(test_maths_fastMap_U8xU8_exhaustive);
+    RUN_TEST(test_maths_fastMap_U16xU8_exhaustive);
+    RUN_TEST(test_maths_fastMap_U8xU16_exhaustive);
+    RUN_TEST(test_maths_mulDiv_U8xU8_exhaustive);
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+    RUN_TEST(test_maths_fastMap_reciprocal_lut_exhaustive);
+#endif
+    RUN_TEST(test_maths_fastMapConstantTime);
+    RUN_TEST(test_maths_fastMapConstantTime_32bit);
+#if defined(FAST_MAP_INT24)
+    RUN_TEST(test_maths_fastMap_24bit);
+#endif
   }
 }
\ No newline at end of file
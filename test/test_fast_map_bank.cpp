@@ -0,0 +1,115 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-bank.h"
+#include "test_utils.h"
+
+// A mix of directions & range sizes, including a channel with a single output value
+static const fast_map_bank_ranges<10, int16_t, int16_t> ranges FAST_MAP_PROGMEM = {
+  { 0,    0,    1023, -1500,  -512, 102, 3,   -30000, 0,    7 },
+  { 1023, 1023, 0,    -11123, 511,  921, 233, 30000,  4095, 9 },
+  { 0,    -40,  100,  1200,   5000, 0,   0,   -32000, 0,    55 },
+  { 100,  150,  0,    5000,   -5000,100, 255, 32000,  3300, 55 },
+};
+
+template <uint8_t N, typename TIn, typename TOut, bool CacheReciprocal>
+static void assert_fast_map_bank(const fast_map_bank<N, TIn, TOut, CacheReciprocal> &bank, const fast_map_bank_ranges<N, TIn, TOut> &expected, int32_t first, int32_t last, int32_t step) {
+  for (uint8_t channel = 0; channel < N; ++channel) {
+    for (int32_t in = first; in <= last; in += step) {
+      char szMsg[64];
+      sprintf(szMsg, "Channel %" PRIu8 ", In %" PRId32, channel, in);
+      TEST_ASSERT_EQUAL_MESSAGE(fast_map((TIn)in, expected.inMin[channel], expected.inMax[channel], expected.outMin[channel], expected.outMax[channel]),
+                                bank.map(channel, (TIn)in), szMsg);
+    }
+  }
+}
+
+static fast_map_bank_ranges<10, int16_t, int16_t> ranges_from_progmem(void) {
+  return fast_map_impl::progmem_reader::read(&ranges);
+}
+
+static void test_fast_map_bank_exact(void)
+{
+  const fast_map_bank_ranges<10, int16_t, int16_t> sramRanges = ranges_from_progmem();
+  const fast_map_bank<10, int16_t, int16_t> bank(sramRanges);
+  // Includes out of range inputs
+  assert_fast_map_bank(bank, sramRanges, -2000, 5000, 7);
+  assert_fast_map_bank(bank, sramRanges, INT16_MIN, INT16_MAX, 251);
+
+  const fast_map_bank_ranges<3, uint16_t, uint8_t> adcRanges = { { 0, 1023, 102 }, { 1023, 0, 921 }, { 0, 0, 0 }, { 255, 100, 100 } };
+  const fast_map_bank<3, uint16_t, uint8_t> adcBank(adcRanges);
+  assert_fast_map_bank(adcBank, adcRanges, 0, 1100, 1);
+}
+
+static void test_fast_map_bank_reciprocal(void)
+{
+  const fast_map_bank_ranges<10, int16_t, int16_t> sramRanges = ranges_from_progmem();
+  fast_map_bank<10, int16_t, int16_t, true> bank(sramRanges);
+  // Includes out of range inputs
+  assert_fast_map_bank(bank, sramRanges, -2000, 5000, 7);
+  assert_fast_map_bank(bank, sramRanges, INT16_MIN, INT16_MAX, 251);
+
+  bank.set(4, 511, -512, 5000, -5000);
+  TEST_ASSERT_EQUAL_INT16(fast_map((int16_t)100, (int16_t)511, (int16_t)-512, (int16_t)5000, (int16_t)-5000), bank.map(4, 100));
+
+  const fast_map_bank_ranges<3, uint16_t, uint8_t> adcRanges = { { 0, 1023, 102 }, { 1023, 0, 921 }, { 0, 0, 0 }, { 255, 100, 100 } };
+  const fast_map_bank<3, uint16_t, uint8_t, true> adcBank(adcRanges);
+  assert_fast_map_bank(adcBank, adcRanges, 0, 1100, 1);
+}
+
+// The default layout is the raw ranges' SRAM, plus a direction bit per channel
+static_assert(sizeof(fast_map_bank<16, uint16_t, int16_t>)==sizeof(fast_map_bank_ranges<16, uint16_t, int16_t>)+2U, "Unexpected bank size");
+static_assert(sizeof(fast_map_bank<16, uint8_t, uint8_t>)==sizeof(fast_map_bank_ranges<16, uint8_t, uint8_t>)+2U, "Unexpected bank size");
+
+static void test_fast_map_bank_load(void)
+{
+  const fast_map_bank_ranges<10, int16_t, int16_t> sramRanges = ranges_from_progmem();
+  fast_map_bank<10, int16_t, int16_t> bank;
+  // Not yet loaded
+  TEST_ASSERT_EQUAL_INT16(0, bank.map(3, 1000));
+
+  bank.load_P(&ranges);
+  assert_fast_map_bank(bank, sramRanges, -2000, 5000, 13);
+
+  // Change one channel, including its direction
+  bank.set(4, 511, -512, 5000, -5000);
+  TEST_ASSERT_EQUAL_INT16(fast_map((int16_t)100, (int16_t)511, (int16_t)-512, (int16_t)5000, (int16_t)-5000), bank.map(4, 100));
+  bank.set(4, -512, 511, 5000, -5000);
+  TEST_ASSERT_EQUAL_INT16(fast_map((int16_t)100, (int16_t)-512, (int16_t)511, (int16_t)5000, (int16_t)-5000), bank.map(4, 100));
+  TEST_ASSERT_EQUAL_INT16(fast_map((int16_t)100, (int16_t)-1500, (int16_t)-11123, (int16_t)1200, (int16_t)5000), bank.map(3, 100));
+
+#if defined(__AVR__)
+  static fast_map_bank_ranges<10, int16_t, int16_t> EEMEM eepromRanges;
+  eeprom_update_block(&sramRanges, &eepromRanges, sizeof(sramRanges));
+  fast_map_bank<10, int16_t, int16_t> eepromBank;
+  eepromBank.load_eeprom(&eepromRanges);
+  assert_fast_map_bank(eepromBank, sramRanges, -2000, 5000, 13);
+#endif
+}
+
+static void test_fast_map_bank_map_all(void)
+{
+  const fast_map_bank_ranges<10, int16_t, int16_t> sramRanges = ranges_from_progmem();
+  fast_map_bank<10, int16_t, int16_t> bank;
+  bank.load_P(&ranges);
+
+  int16_t in[10];
+  int16_t out[10];
+  for (int16_t offset = -100; offset <= 4500; offset = (int16_t)(offset + 37)) {
+    for (uint8_t channel = 0; channel < 10U; ++channel) {
+      in[channel] = (int16_t)(offset + channel);
+    }
+    bank.map_all(in, out);
+    for (uint8_t channel = 0; channel < 10U; ++channel) {
+      TEST_ASSERT_EQUAL_INT16(fast_map(in[channel], sramRanges.inMin[channel], sramRanges.inMax[channel], sramRanges.outMin[channel], sramRanges.outMax[channel]), out[channel]);
+    }
+  }
+}
+
+void test_fast_map_bank(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_map_bank_exact);
+    RUN_TEST(test_fast_map_bank_reciprocal);
+    RUN_TEST(test_fast_map_bank_load);
+    RUN_TEST(test_fast_map_bank_map_all);
+  }
+}
@@ -0,0 +1,67 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-cached.h"
+#include "test_utils.h"
+
+// A mix of repeated inputs, single steps (both directions) & jumps
+template <typename TIn, typename TOut>
+static void assert_fast_cached_mapper(TIn inMin, TIn inMax, TOut outMin, TOut outMax, TIn first, TIn last) {
+  fast_cached_mapper<TIn, TOut> mapper(inMin, inMax, outMin, outMax);
+  const int32_t moves[] = { 0, 1, 1, 0, -1, -1, -1, 0, 7, -1, 1, 1, -5, 0 };
+  int32_t in = first;
+  while (in + 8 <= (int32_t)last) {
+    for (uint8_t index = 0; index < sizeof(moves)/sizeof(moves[0]); ++index) {
+      const int32_t next = in + moves[index];
+      if (next >= (int32_t)first && next <= (int32_t)last) {
+        in = next;
+      }
+      char szMsg[64];
+      sprintf(szMsg, "In %" PRId32, in);
+      TEST_ASSERT_EQUAL_MESSAGE(fast_map((TIn)in, inMin, inMax, outMin, outMax), mapper.map((TIn)in), szMsg);
+    }
+    in = in + 3;
+  }
+}
+
+static void test_fast_cached_mapper_exact(void)
+{
+  assert_fast_cached_mapper<uint8_t, uint8_t>(3, 233, 0, 255, 0, UINT8_MAX);
+  assert_fast_cached_mapper<uint8_t, uint16_t>(233, 3, 1000, 100, 0, UINT8_MAX);
+  // Crosses inMin
+  assert_fast_cached_mapper<int16_t, int16_t>(-1500, -11123, 1200, 5000, -2000, 1000);
+  assert_fast_cached_mapper<uint16_t, uint8_t>(0, 1023, 0, 100, 0, 1100);
+  assert_fast_cached_mapper<int8_t, int32_t>(-100, 100, 2000000000L, -2000000000L, INT8_MIN, INT8_MAX);
+}
+
+static void test_fast_cached_mapper_hysteresis(void)
+{
+  fast_cached_mapper<uint16_t, uint8_t> mapper(0, 1000, 0, 100, 5);
+
+  TEST_ASSERT_EQUAL_UINT8(50, mapper.map(509));
+  // Jitter within the hysteresis band: the output is held
+  TEST_ASSERT_EQUAL_UINT8(50, mapper.map(504));
+  TEST_ASSERT_EQUAL_UINT8(50, mapper.map(514));
+  // Outside the band: updated, and the band moves with the new input
+  TEST_ASSERT_EQUAL_UINT8(51, mapper.map(515));
+  TEST_ASSERT_EQUAL_UINT8(51, mapper.map(510));
+  TEST_ASSERT_EQUAL_UINT8(50, mapper.map(509));
+  TEST_ASSERT_EQUAL_UINT8(0, mapper.map(0));
+
+#if defined(FAST_MAP_STATISTICS)
+  // Inputs within the hysteresis are hits: 504, 514 & 510. The rest are misses
+  TEST_ASSERT_EQUAL_UINT16(3, mapper.statistics().hits);
+  TEST_ASSERT_EQUAL_UINT16(0, mapper.statistics().steps);
+  TEST_ASSERT_EQUAL_UINT16(4, mapper.statistics().misses);
+  TEST_ASSERT_EQUAL_UINT8(0, mapper.map(1));
+  TEST_ASSERT_EQUAL_UINT16(4, mapper.statistics().hits);
+  mapper.reset_statistics();
+  TEST_ASSERT_EQUAL_UINT16(0, mapper.statistics().hits);
+#endif
+}
+
+void test_fast_map_cached(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_cached_mapper_exact);
+    RUN_TEST(test_fast_cached_mapper_hysteresis);
+  }
+}
@@ -0,0 +1,95 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-compose.h"
+#include "test_utils.h"
+
+// The exact (infinite precision) chain of 2 maps, truncated once at the end
+static int32_t exact_chain(int32_t in, const fast_map_ranges &first, const fast_map_ranges &second) {
+  const int64_t firstInRange = (int64_t)first.inMax - first.inMin;
+  const int64_t secondInRange = (int64_t)second.inMax - second.inMin;
+  // (intermediate - second.inMin) * firstInRange
+  const int64_t numerator = ((int64_t)first.outMin - second.inMin) * firstInRange
+                          + ((int64_t)in - first.inMin) * ((int64_t)first.outMax - first.outMin);
+  return (int32_t)(second.outMin + (numerator * ((int64_t)second.outMax - second.outMin)) / (firstInRange * secondInRange));
+}
+
+template <typename TIn, typename TOut, typename TScaled>
+static void assert_composed(const fast_map_ranges &first, const fast_map_ranges &second, int32_t from, int32_t to, int32_t step) {
+  const fast_composed_mapper<TIn, TOut, TScaled> mapper(fast_map_compose(first, second));
+  for (int32_t in = from; in <= to; in += step) {
+    char szMsg[64];
+    sprintf(szMsg, "In %" PRId32, in);
+    TEST_ASSERT_EQUAL_MESSAGE((TOut)exact_chain(in, first, second), mapper.map((TIn)in), szMsg);
+  }
+}
+
+static void test_fast_composed_mapper_exact(void)
+{
+  // ADC counts => millivolts => kPa
+  assert_composed<uint16_t, uint8_t, int32_t>({ 0, 1023, 0, 5000 }, { 500, 4500, 0, 100 }, 103, 920, 1);
+  // Out of range inputs & intermediate values
+  assert_composed<uint16_t, int16_t, int32_t>({ 0, 1023, 0, 5000 }, { 500, 4500, 0, 100 }, 0, 1100, 1);
+  // Inverted ranges & signed types
+  assert_composed<int16_t, int16_t, int32_t>({ -1000, 1000, 3000, -3000 }, { -2500, 2500, -7, 1900 }, -1200, 1200, 1);
+  assert_composed<uint8_t, uint16_t, int32_t>({ 255, 0, 0, 999 }, { 1000, 0, 60000, 3 }, 0, 255, 1);
+}
+
+static void test_fast_composed_mapper_three_stages(void)
+{
+  // 3 stages: equivalent to composing the first 2 & then the last
+  const fast_map_ranges first = { 0, 4095, 0, 3300 };
+  const fast_map_ranges second = { 0, 3300, -400, 1250 };
+  const fast_map_ranges third = { -400, 1250, 320, 2570 };
+  const fast_composed_mapper<uint16_t, int16_t> mapper(fast_map_compose(first, second, third));
+  // The first 2 stages are the inverse of each other's scale: so the chain is the
+  // same as a single map from the first input range to the last output range
+  for (uint16_t in = 0; in <= 4095U; in = (uint16_t)(in + 3U)) {
+    TEST_ASSERT_EQUAL_INT16(fast_map(in, (uint16_t)0, (uint16_t)4095, (int16_t)320, (int16_t)2570), mapper.map(in));
+  }
+  const fast_map_composition composition = fast_map_compose_append(fast_map_compose(first, second), third);
+  // Reduced to lowest terms: 2250/4095 == (10*5)/91
+  TEST_ASSERT_EQUAL(10, composition.scale);
+  TEST_ASSERT_EQUAL(0, composition.inMin);
+  TEST_ASSERT_EQUAL(91, composition.inRange);
+  TEST_ASSERT_EQUAL(5, composition.outRange);
+}
+
+static void test_fast_map_composed_const(void)
+{
+  // Compile time & setup time compositions are identical
+  const fast_composed_mapper<uint16_t, uint8_t> mapper(fast_map_compose({ 0, 1023, 0, 5000 }, { 500, 4500, 0, 100 }));
+  for (uint16_t in = 0; in <= 1100U; ++in) {
+    TEST_ASSERT_EQUAL_UINT8(mapper.map(in), (fast_map_composed<0, 1023, 0, 5000,  500, 4500, 0, 100>(in)));
+  }
+  const fast_composed_mapper<int16_t, int16_t> signedMapper(fast_map_compose({ -1000, 1000, 3000, -3000 }, { -2500, 2500, -7, 1900 }, { 0, 100, 0, 1000 }));
+  for (int16_t in = -1200; in <= 1200; ++in) {
+    TEST_ASSERT_EQUAL_INT16(signedMapper.map(in), (fast_map_composed<-1000, 1000, 3000, -3000,  -2500, 2500, -7, 1900,  0, 100, 0, 1000>(in)));
+  }
+}
+
+static void test_fast_composed_mapper_32bit(void)
+{
+  // A 32-bit output range: the out of range inputs need more than a 64-bit product
+  const fast_map_ranges first = { 0, 1000, 0, 7 };
+  const fast_map_ranges second = { 0, 22, -INT32_MAX, INT32_MAX };
+  assert_composed<int32_t, int32_t, int32_t>(first, second, 0, 1000, 1);
+  const fast_composed_mapper<int32_t, int32_t> mapper(fast_map_compose(first, second));
+  // Out of range results wrap, like fast_map()
+  TEST_ASSERT_EQUAL_INT32(1068080278, mapper.map(INT32_MIN));
+  TEST_ASSERT_EQUAL_INT32(2146117069, mapper.map(-1));
+  TEST_ASSERT_EQUAL_INT32(-779536564, mapper.map(1001));
+  TEST_ASSERT_EQUAL_INT32(1365944140, mapper.map(1000000000));
+  TEST_ASSERT_EQUAL_INT32(-1069446856, mapper.map(INT32_MAX));
+  TEST_ASSERT_EQUAL_INT32(-1069446856, (fast_map_composed<0, 1000, 0, 7,  0, 22, -INT32_MAX, INT32_MAX>(INT32_MAX)));
+  TEST_ASSERT_EQUAL_INT32(1068080278, (fast_map_composed<0, 1000, 0, 7,  0, 22, -INT32_MAX, INT32_MAX>(INT32_MIN)));
+  TEST_ASSERT_EQUAL_INT32(mapper.map(999), (fast_map_composed<0, 1000, 0, 7,  0, 22, -INT32_MAX, INT32_MAX>((int32_t)999)));
+}
+
+void test_fast_map_compose(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_composed_mapper_exact);
+    RUN_TEST(test_fast_composed_mapper_three_stages);
+    RUN_TEST(test_fast_map_composed_const);
+    RUN_TEST(test_fast_composed_mapper_32bit);
+  }
+}
@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-curve.h"
+#include "test_utils.h"
+
+template <typename TAxis, typename TValue, uint16_t N>
+static TValue naive_curve_map(const TAxis (&axis)[N], const TValue (&values)[N], TAxis in) {
+  if (in<=axis[0]) { return values[0]; }
+  if (in>=axis[N-1]) { return values[N-1]; }
+  uint16_t bin = 0;
+  while (in>axis[bin+1]) { ++bin; }
+  return (TValue)map(in, axis[bin], axis[bin+1], values[bin], values[bin+1]);
+}
+
+template <typename TAxis, typename TValue, uint16_t N>
+static void assert_fast_curve(fast_curve<TAxis, TValue, N> &curve, const TAxis (&axis)[N], const TValue (&values)[N], TAxis in) {
+  char szMsg[64];
+  sprintf(szMsg, "In %" PRId32, (int32_t)in);
+  TEST_ASSERT_EQUAL_MESSAGE(naive_curve_map(axis, values, in), curve.map(in), szMsg);  
+}
+
+static void test_fast_curve_linear_search(void)
+{
+  static const uint8_t axis[] = { 10, 20, 50, 90, 200 };
+  static const uint16_t values[] = { 1000, 800, 2000, 2000, 500 };
+  fast_curve<uint8_t, uint16_t, 5> curve(axis, values);
+
+  // Ascending, descending & random order inputs: the cache must never give a wrong answer
+  for (uint16_t in = 0; in <= UINT8_MAX; ++in) {
+    assert_fast_curve(curve, axis, values, (uint8_t)in);
+  }
+  for (int16_t in = UINT8_MAX; in >= 0; --in) {
+    assert_fast_curve(curve, axis, values, (uint8_t)in);
+  }
+  for (uint16_t in = 0; in <= UINT8_MAX*5U; in = (uint16_t)(in + 37U)) {
+    assert_fast_curve(curve, axis, values, (uint8_t)in);
+  }
+}
+
+static void test_fast_curve_binary_search(void)
+{
+  static const int16_t axis[] = { -4000, -3000, -1000, -500, -20, 0, 10, 100, 250, 800, 1000, 1500, 3000, 3001, 5000, 7000 };
+  static const int16_t values[] = { 50, -20, 400, 400, 300, 0, -100, -3000, 3000, 16000, -16000, 0, 1, 2, 500, 900 };
+  fast_curve<int16_t, int16_t, 16> curve(axis, values);
+
+  for (int16_t in = -5000; in <= 8000; ++in) {
+    assert_fast_curve(curve, axis, values, in);
+  }
+  for (int16_t in = 8000; in >= -5000; in = (int16_t)(in - 13)) {
+    assert_fast_curve(curve, axis, values, in);
+  }
+  for (uint16_t i = 0; i < 1000U; ++i) {
+    assert_fast_curve(curve, axis, values, (int16_t)(((i * 7919U) % 13000U) - 5000));
+  }
+}
+
+static void test_fast_curve_modify(void)
+{
+  static const uint8_t axis[] = { 10, 20, 50 };
+  static const uint8_t values[] = { 0, 100, 200 };
+  fast_curve<uint8_t, uint8_t, 3> curve(axis, values);
+
+  TEST_ASSERT_EQUAL_UINT8(50, curve.map(15));
+  curve.values()[1] = 50;
+  TEST_ASSERT_EQUAL_UINT8(25, curve.map(15));
+  curve.axis()[1] = 40;
+  TEST_ASSERT_EQUAL_UINT8(8, curve.map(15));
+  TEST_ASSERT_EQUAL_UINT8(125, curve.map(45));
+}
+
+void test_fast_map_curve(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_curve_linear_search);
+    RUN_TEST(test_fast_curve_binary_search);
+    RUN_TEST(test_fast_curve_modify);
+  }
+}
@@ -0,0 +1,303 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map.h"
+#include "test_utils.h"
+#include "cycle_counter.hpp"
+#include "cycle_budgets.h"
+
+// Cycle counts per call for every combination of input & output type, with
+// normal & inverted input & output ranges, over the worst case inputs.
+//
+// Each combination is output as a comma separated row, prefixed with "CYCLES"
+// for easy extraction from the test log. E.g.
+//   CYCLES,u16,u8,normal,inverted,612,141,187,96,600,ok
+// Columns: input type, input direction, output type, output direction, map() max 
+// cycles, fast_map() min & max cycles, fast_mapper::map() max cycles, budget, status.
+//
+// Any combination where fast_map() exceeds its budget (see cycle_budgets.h)
+// fails the test. The build (optimized, or unoptimized for UNOPTIMIZED_BUILD) & 
+// the mode (inline, or size for FAST_MAP_OPTIMIZE_SIZE) are logged first: the build
+// selects the budgets cycle_report.py generates. Compare the fast_map() columns of
+// the 2 modes for the per call overhead of the out of line kernels.
+//
+// fast_map_constant_time() is measured over every input (or an even sample, for 
+// 32-bit inputs): the min, max & spread are logged. Every input must take the same
+// number of cycles (a spread of 0), within the budget for the product width.
+
+#if defined(CYCLE_COUNTER_AVAILABLE)
+
+template <typename T> struct bench_type;
+
+template <> struct bench_type<uint8_t> {
+    static constexpr uint8_t index = 0;
+    static const char *name(void) { return "u8"; }
+    static uint8_t lowest(void) { return 0; }
+    static uint8_t highest(void) { return UINT8_MAX; }
+    static uint8_t rangeMin(void) { return 3; }
+    static uint8_t rangeMax(void) { return 233; }
+};
+template <> struct bench_type<int8_t> {
+    static constexpr uint8_t index = 1;
+    static const char *name(void) { return "s8"; }
+    static int8_t lowest(void) { return INT8_MIN; }
+    static int8_t highest(void) { return INT8_MAX; }
+    static int8_t rangeMin(void) { return -100; }
+    static int8_t rangeMax(void) { return 110; }
+};
+template <> struct bench_type<uint16_t> {
+    static constexpr uint8_t index = 2;
+    static const char *name(void) { return "u16"; }
+    static uint16_t lowest(void) { return 0; }
+    static uint16_t highest(void) { return UINT16_MAX; }
+    static uint16_t rangeMin(void) { return 1521; }
+    static uint16_t rangeMax(void) { return 53333; }
+};
+template <> struct bench_type<int16_t> {
+    static constexpr uint8_t index = 3;
+    static const char *name(void) { return "s16"; }
+    static int16_t lowest(void) { return INT16_MIN; }
+    static int16_t highest(void) { return INT16_MAX; }
+    static int16_t rangeMin(void) { return -30000; }
+    static int16_t rangeMax(void) { return 29000; }
+};
+template <> struct bench_type<uint32_t> {
+    static constexpr uint8_t index = 4;
+    static const char *name(void) { return "u32"; }
+    static uint32_t lowest(void) { return 0; }
+    static uint32_t highest(void) { return UINT32_MAX; }
+    static uint32_t rangeMin(void) { return 5; }
+    static uint32_t rangeMax(void) { return 4000000000UL; }
+};
+template <> struct bench_type<int32_t> {
+    static constexpr uint8_t index = 5;
+    static const char *name(void) { return "s32"; }
+    static int32_t lowest(void) { return INT32_MIN; }
+    static int32_t highest(void) { return INT32_MAX; }
+    static int32_t rangeMin(void) { return -2000000000L; }
+    static int32_t rangeMax(void) { return 2000000000L; }
+};
+
+struct cell_cycles {
+    uint16_t mapMax;
+    uint16_t fastMapMin;
+    uint16_t fastMapMax;
+    uint16_t mapperMax;
+};
+
+static inline uint16_t net_cycles(uint16_t gross, uint16_t overhead) {
+    return gross>overhead ? (uint16_t)(gross - overhead) : 0U;
+}
+
+template <typename TIn, typename TOut>
+static void measure_input(TIn input, TIn inMin, TIn inMax, TOut outMin, TOut outMax, cell_cycles &cycles) {
+    // All arguments are volatile, so the calls can't be optimized away
+    // or evaluated at compile time.
+    volatile TIn in = input;
+    volatile TIn vInMin = inMin;
+    volatile TIn vInMax = inMax;
+    volatile TOut vOutMin = outMin;
+    volatile TOut vOutMax = outMax;
+    volatile TOut result;
+    const fast_mapper<TIn, TOut> mapper(vInMin, vInMax, vOutMin, vOutMax);
+
+    const uint16_t overhead = measure_cycles([&] {
+        // Just the argument loads & result store
+        const TIn a = in, b = vInMin, c = vInMax;
+        const TOut d = vOutMin;
+        result = vOutMax;
+        (void)a; (void)b; (void)c; (void)d;
+    });
+    const uint16_t mapCycles = net_cycles(measure_cycles([&] {
+        result = (TOut)map(in, vInMin, vInMax, vOutMin, vOutMax);
+    }), overhead);
+    const uint16_t fastMapCycles = net_cycles(measure_cycles([&] {
+        result = fast_map((TIn)in, (TIn)vInMin, (TIn)vInMax, (TOut)vOutMin, (TOut)vOutMax);
+    }), overhead);
+    const uint16_t mapperCycles = net_cycles(measure_cycles([&] {
+        result = mapper.map(in);
+    }), overhead);
+
+    cycles.mapMax = max(cycles.mapMax, mapCycles);
+    cycles.fastMapMin = min(cycles.fastMapMin, fastMapCycles);
+    cycles.fastMapMax = max(cycles.fastMapMax, fastMapCycles);
+    cycles.mapperMax = max(cycles.mapperMax, mapperCycles);
+}
+
+// Returns true if the combination is within budget
+template <typename TIn, typename TOut>
+static bool measure_cell(bool inInverted, bool outInverted) {
+    const TIn inMin = inInverted ? bench_type<TIn>::rangeMax() : bench_type<TIn>::rangeMin();
+    const TIn inMax = inInverted ? bench_type<TIn>::rangeMin() : bench_type<TIn>::rangeMax();
+    const TOut outMin = outInverted ? bench_type<TOut>::rangeMax() : bench_type<TOut>::rangeMin();
+    const TOut outMax = outInverted ? bench_type<TOut>::rangeMin() : bench_type<TOut>::rangeMax();
+
+    // Range end points, mid point & out of range inputs: these cover the
+    // largest intermediate values & the slow paths.
+    const TIn inputs[] = {
+        bench_type<TIn>::rangeMin(),
+        bench_type<TIn>::rangeMax(),
+        (TIn)(bench_type<TIn>::rangeMax() - 1),
+        (TIn)((bench_type<TIn>::rangeMin() / 2) + (bench_type<TIn>::rangeMax() / 2)),
+        bench_type<TIn>::lowest(),
+        bench_type<TIn>::highest(),
+    };
+
+    cell_cycles cycles = { 0, UINT16_MAX, 0, 0 };
+    for (uint8_t index=0; index<sizeof(inputs)/sizeof(inputs[0]); ++index) {
+        measure_input(inputs[index], inMin, inMax, outMin, outMax, cycles);
+    }
+
+    const uint16_t budget = (uint16_t)(fast_map_cycle_budgets[bench_type<TIn>::index][bench_type<TOut>::index] + fast_map_call_overhead_budget);
+    const bool withinBudget = cycles.fastMapMax<=budget;
+
+    char buffer[128];
+    sprintf(buffer, "CYCLES,%s,%s,%s,%s,%u,%u,%u,%u,%u,%s",
+            bench_type<TIn>::name(), inInverted ? "inverted" : "normal",
+            bench_type<TOut>::name(), outInverted ? "inverted" : "normal",
+            (unsigned)cycles.mapMax, (unsigned)cycles.fastMapMin, (unsigned)cycles.fastMapMax,
+            (unsigned)cycles.mapperMax, (unsigned)budget, withinBudget ? "ok" : "OVER");
+    TEST_MESSAGE(buffer);
+
+    return withinBudget;
+}
+
+template <typename TIn>
+static void test_cycles_input_type(void) {
+    uint8_t overBudget = 0;
+    // Bit 0: output range inverted, bit 1: input range inverted
+    for (uint8_t direction=0; direction<4; ++direction) {
+        const bool inInverted = (direction & 2U)!=0U;
+        const bool outInverted = (direction & 1U)!=0U;
+        overBudget += measure_cell<TIn, uint8_t>(inInverted, outInverted) ? 0 : 1;
+        overBudget += measure_cell<TIn, int8_t>(inInverted, outInverted) ? 0 : 1;
+        overBudget += measure_cell<TIn, uint16_t>(inInverted, outInverted) ? 0 : 1;
+        overBudget += measure_cell<TIn, int16_t>(inInverted, outInverted) ? 0 : 1;
+        overBudget += measure_cell<TIn, uint32_t>(inInverted, outInverted) ? 0 : 1;
+        overBudget += measure_cell<TIn, int32_t>(inInverted, outInverted) ? 0 : 1;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, overBudget, "fast_map() cycle budget exceeded");
+}
+
+static void test_cycles_header(void) {
+#if defined(UNOPTIMIZED_BUILD)
+    TEST_MESSAGE("CYCLES_BUILD,unoptimized");
+#else
+    TEST_MESSAGE("CYCLES_BUILD,optimized");
+#endif
+#if defined(FAST_MAP_OPTIMIZE_SIZE)
+    TEST_MESSAGE("CYCLES_MODE,size");
+#else
+    TEST_MESSAGE("CYCLES_MODE,inline");
+#endif
+    TEST_MESSAGE("CYCLES,in,in_direction,out,out_direction,map_max,fast_map_min,fast_map_max,fast_mapper_max,budget,status");
+}
+
+static void test_cycles_u8(void) { test_cycles_input_type<uint8_t>(); }
+static void test_cycles_s8(void) { test_cycles_input_type<int8_t>(); }
+static void test_cycles_u16(void) { test_cycles_input_type<uint16_t>(); }
+static void test_cycles_s16(void) { test_cycles_input_type<int16_t>(); }
+static void test_cycles_u32(void) { test_cycles_input_type<uint32_t>(); }
+static void test_cycles_s32(void) { test_cycles_input_type<int32_t>(); }
+
+// fast_map_constant_time(): the cycle count must not depend on the input. Logged
+// as rows prefixed with "CONSTANT_TIME". Columns: input type, output type, output
+// direction, min cycles, max cycles, spread, budget, status.
+//
+// A budget of 0 logs the row without checking it.
+//
+// 64-bit products (any 32-bit type) share a budget: they all use the same 32x32-bit
+// word arithmetic.
+template <typename TIn, typename TOut>
+static void measure_constant_time(bool inverted, uint32_t inputCount, uint32_t stride, uint16_t budget) {
+    volatile TIn in = bench_type<TIn>::lowest();
+    volatile TIn vInMin = bench_type<TIn>::rangeMin();
+    volatile TIn vInMax = bench_type<TIn>::rangeMax();
+    volatile TOut vOutMin = inverted ? bench_type<TOut>::rangeMax() : bench_type<TOut>::rangeMin();
+    volatile TOut vOutMax = inverted ? bench_type<TOut>::rangeMin() : bench_type<TOut>::rangeMax();
+    volatile TOut result;
+
+    const uint16_t overhead = measure_cycles([&] {
+        const TIn a = in, b = vInMin, c = vInMax;
+        const TOut d = vOutMin;
+        result = vOutMax;
+        (void)a; (void)b; (void)c; (void)d;
+    });
+
+    uint16_t minCycles = UINT16_MAX;
+    uint16_t maxCycles = 0;
+    TIn input = bench_type<TIn>::lowest();
+    for (uint32_t index=0; index<inputCount; ++index) {
+        in = input;
+        const uint16_t cycles = net_cycles(measure_cycles([&] {
+            result = fast_map_constant_time((TIn)in, (TIn)vInMin, (TIn)vInMax, (TOut)vOutMin, (TOut)vOutMax);
+        }), overhead);
+        minCycles = min(minCycles, cycles);
+        maxCycles = max(maxCycles, cycles);
+        input = (TIn)(input + stride);
+    }
+
+    const uint16_t spread = (uint16_t)(maxCycles - minCycles);
+    const bool ok = maxCycles<=budget && spread==0U;
+    char buffer[128];
+    sprintf(buffer, "CONSTANT_TIME,%s,%s,%s,%u,%u,%u,%u,%s",
+            bench_type<TIn>::name(), bench_type<TOut>::name(), inverted ? "inverted" : "normal",
+            (unsigned)minCycles, (unsigned)maxCycles, (unsigned)spread, (unsigned)budget, 
+            budget==0U ? "logged" : (ok ? "ok" : "FAIL"));
+    TEST_MESSAGE(buffer);
+
+    if (budget!=0U) {
+      TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(budget, maxCycles, "fast_map_constant_time() cycle budget exceeded");
+      TEST_ASSERT_EQUAL_MESSAGE(0, spread, "fast_map_constant_time() timing depends on the input");
+    }
+}
+
+// Every input for 8 & 16-bit types
+static void test_cycles_constant_time_8x8(void) {
+    measure_constant_time<uint8_t, uint8_t>(false, 256UL, 1UL, fast_map_constant_time_budget_16);
+    measure_constant_time<int8_t, int8_t>(true, 256UL, 1UL, fast_map_constant_time_budget_16);
+}
+
+static void test_cycles_constant_time_16x8(void) {
+    measure_constant_time<uint16_t, uint8_t>(false, 65536UL, 1UL, fast_map_constant_time_budget_24);
+    measure_constant_time<int8_t, int16_t>(true, 256UL, 1UL, fast_map_constant_time_budget_24);
+}
+
+static void test_cycles_constant_time_16x16(void) {
+    measure_constant_time<int16_t, int16_t>(false, 65536UL, 1UL, fast_map_constant_time_budget_32);
+    measure_constant_time<uint16_t, uint16_t>(true, 65536UL, 1UL, fast_map_constant_time_budget_32);
+}
+
+// 32-bit types (64-bit products): a sample spread evenly over the input type's range
+static void test_cycles_constant_time_32(void) {
+    measure_constant_time<uint32_t, uint32_t>(false, 4096UL, 1048573UL, fast_map_constant_time_budget_64);
+    measure_constant_time<int32_t, int8_t>(true, 4096UL, 1048573UL, fast_map_constant_time_budget_64);
+    measure_constant_time<uint8_t, int32_t>(false, 256UL, 1UL, fast_map_constant_time_budget_64);
+}
+
+#else
+
+static void test_cycles_unavailable(void) {
+    TEST_IGNORE_MESSAGE("No cycle counter on this platform");
+}
+
+#endif
+
+void test_fast_map_cycles(void) {
+  SET_UNITY_FILENAME() {
+#if defined(CYCLE_COUNTER_AVAILABLE)
+    RUN_TEST(test_cycles_header);
+    RUN_TEST(test_cycles_u8);
+    RUN_TEST(test_cycles_s8);
+    RUN_TEST(test_cycles_u16);
+    RUN_TEST(test_cycles_s16);
+    RUN_TEST(test_cycles_u32);
+    RUN_TEST(test_cycles_s32);
+    RUN_TEST(test_cycles_constant_time_8x8);
+    RUN_TEST(test_cycles_constant_time_16x8);
+    RUN_TEST(test_cycles_constant_time_16x16);
+    RUN_TEST(test_cycles_constant_time_32);
+#else
+    RUN_TEST(test_cycles_unavailable);
+#endif
+  }
+}
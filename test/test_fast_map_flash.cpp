@@ -0,0 +1,43 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map.h"
+#include "test_utils.h"
+
+// Flash size probes: one out of line wrapper per type combination, so each
+// fast_map() instantiation has its own symbol in the firmware ELF. flash_report.py
+// lists the size of each probe (the cost of one call site) and of the shared
+// fast_map_impl::mapKernel copies (FAST_MAP_OPTIMIZE_SIZE only).
+//
+// The probes are also checked against map(), so the results are identical in both
+// build modes.
+#define FAST_MAP_FLASH_PROBE(name, TIn, TOut) \
+  static __attribute__((noinline, used)) TOut fast_map_flash_ ## name(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) { \
+    return fast_map(in, inMin, inMax, outMin, outMax); \
+  }
+
+FAST_MAP_FLASH_PROBE(u8_u8, uint8_t, uint8_t)
+FAST_MAP_FLASH_PROBE(s8_s8, int8_t, int8_t)
+FAST_MAP_FLASH_PROBE(u8_u16, uint8_t, uint16_t)
+FAST_MAP_FLASH_PROBE(u16_u8, uint16_t, uint8_t)
+FAST_MAP_FLASH_PROBE(u16_u16, uint16_t, uint16_t)
+FAST_MAP_FLASH_PROBE(s16_s16, int16_t, int16_t)
+FAST_MAP_FLASH_PROBE(u16_s32, uint16_t, int32_t)
+FAST_MAP_FLASH_PROBE(s32_s32, int32_t, int32_t)
+
+static void test_fast_map_flash_probes(void)
+{
+  TEST_ASSERT_EQUAL_UINT8(map(100, 3, 233, 0, 255), fast_map_flash_u8_u8(100, 3, 233, 0, 255));
+  TEST_ASSERT_EQUAL_INT8(map(-50, -100, 110, 127, -128), fast_map_flash_s8_s8(-50, -100, 110, 127, -128));
+  TEST_ASSERT_EQUAL_UINT16(map(200, 233, 3, 100, 50000), fast_map_flash_u8_u16(200, 233, 3, 100, 50000));
+  TEST_ASSERT_EQUAL_UINT8(map(700, 0, 1023, 0, 100), fast_map_flash_u16_u8(700, 0, 1023, 0, 100));
+  TEST_ASSERT_EQUAL_UINT16(map(20000, 1521, 53333, 65535, 0), fast_map_flash_u16_u16(20000, 1521, 53333, 65535, 0));
+  TEST_ASSERT_EQUAL_INT16(map(-31000, -30000, 29000, -1200, 5000), fast_map_flash_s16_s16(-31000, -30000, 29000, -1200, 5000));
+  TEST_ASSERT_EQUAL_INT32(map(512, 0, 1023, -2000000000L, 2000000000L), fast_map_flash_u16_s32(512, 0, 1023, -2000000000L, 2000000000L));
+  TEST_ASSERT_EQUAL_INT32(fast_map(-1000000L, -5000000L, 5000000L, 0L, 1000L), fast_map_flash_s32_s32(-1000000L, -5000000L, 5000000L, 0L, 1000L));
+}
+
+void test_fast_map_flash(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_map_flash_probes);
+  }
+}
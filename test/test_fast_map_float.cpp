@@ -0,0 +1,135 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include "avr-fast-map-float.h"
+#include "test_utils.h"
+
+// The usual float formula
+static float naive_float_map(float in, float inMin, float inMax, float outMin, float outMax) {
+  return (in - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Float results: within 1 unit in the last place of the output magnitude of the
+// usual formula
+static void assert_float_map(float inMin, float inMax, float outMin, float outMax, float first, float last, float step) {
+  const fast_float_mapper<float, float> mapper(inMin, inMax, outMin, outMax);
+  const float magnitude = fabsf(outMax - outMin) + fabsf(outMin);
+  for (float in = first; in <= last; in += step) {
+    const float expected = naive_float_map(in, inMin, inMax, outMin, outMax);
+    TEST_ASSERT_FLOAT_WITHIN(magnitude * 2.4E-7F, expected, fast_map(in, inMin, inMax, outMin, outMax));
+    TEST_ASSERT_EQUAL_FLOAT(fast_map(in, inMin, inMax, outMin, outMax), mapper.map(in));
+  }
+}
+
+static void test_fast_map_float_float(void)
+{
+  assert_float_map(-300.0F, 700.0F, -1.5F, 2.75F, -350.0F, 750.0F, 0.37F);
+  assert_float_map(0.0F, 1.0F, 100.0F, -100.0F, 0.0F, 1.0F, 0.001F);
+  assert_float_map(4.5F, 0.5F, 0.0F, 100.0F, 0.0F, 5.0F, 0.01F);
+}
+
+// Integral input, float output: 10-bit ADC => volts
+static void test_fast_map_float_integral_in(void)
+{
+  const fast_float_mapper<uint16_t, float> mapper(0, 1023, 0.0F, 5.0F);
+  for (uint16_t in = 0; in <= 1100U; ++in) {
+    const float expected = naive_float_map(in, 0.0F, 1023.0F, 0.0F, 5.0F);
+    TEST_ASSERT_FLOAT_WITHIN(5.0F * 2.4E-7F, expected, fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, 5.0F));
+    TEST_ASSERT_EQUAL_FLOAT(fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, 5.0F), mapper.map(in));
+  }
+  TEST_ASSERT_EQUAL_FLOAT(-0.5F, fast_map((int8_t)-10, (int8_t)0, (int8_t)100, 0.0F, 5.0F));
+}
+
+// Float input, integral output: truncated towards outMin, like fast_map(). Float
+// rounding near an integral result can give a result 1 away from the exact one
+template <typename TIn, typename TOut>
+static void assert_integral_out(TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+  const fast_float_mapper<float, TOut> mapper((float)inMin, (float)inMax, outMin, outMax);
+  const int32_t first = inMin < inMax ? inMin : inMax;
+  const int32_t last = inMin < inMax ? inMax : inMin;
+  for (int32_t in = first; in <= last; ++in) {
+    char szMsg[64];
+    sprintf(szMsg, "In %" PRId32, in);
+    const TOut expected = fast_map((TIn)in, inMin, inMax, outMin, outMax);
+    const TOut actual = fast_map((float)in, (float)inMin, (float)inMax, outMin, outMax);
+    TEST_ASSERT_INT_WITHIN_MESSAGE(1, expected, actual, szMsg);
+    TEST_ASSERT_EQUAL_MESSAGE(actual, mapper.map((float)in), szMsg);
+  }
+}
+
+static void test_fast_map_float_integral_out(void)
+{
+  assert_integral_out<int16_t, uint8_t>(-40, 150, 0, 255);
+  assert_integral_out<int16_t, int16_t>(-1500, -11123, 1200, 5000);
+  assert_integral_out<uint16_t, uint16_t>(1521, 53333, 65535, 0);
+  assert_integral_out<int16_t, int16_t>(-2000, 2000, -30000, 29999);
+}
+
+// A fixed pseudo random sequence (a linear congruential generator), so every run
+// checks the same values
+static uint16_t next_random(uint32_t &state) {
+  state = (uint32_t)((state * 1664525UL) + 1013904223UL);
+  return (uint16_t)(state >> 16U);
+}
+
+// The documented rate of results that differ from the exact result: over random 16-bit
+// ranges & in range inputs, fewer than 1 in 1000 (and never by more than 1)
+static void test_fast_map_float_integral_out_rate(void)
+{
+  uint32_t state = 12345UL;
+  uint16_t mismatches = 0;
+  uint16_t count = 0;
+  for (uint16_t range = 0; range < 400U; ++range) {
+    const uint16_t inMin = next_random(state);
+    const uint16_t inMax = next_random(state);
+    const int16_t outMin = (int16_t)next_random(state);
+    const int16_t outMax = (int16_t)next_random(state);
+    if (inMin==inMax) {
+      continue;
+    }
+    const uint16_t low = inMin < inMax ? inMin : inMax;
+    const uint32_t width = (uint32_t)(inMin < inMax ? inMax - inMin : inMin - inMax) + 1UL;
+    for (uint8_t index = 0; index < 50U; ++index) {
+      const uint16_t in = (uint16_t)(low + (uint16_t)(((uint32_t)next_random(state) * width) >> 16U));
+      const int16_t expected = fast_map(in, inMin, inMax, outMin, outMax);
+      const int16_t actual = fast_map((float)in, (float)inMin, (float)inMax, outMin, outMax);
+      TEST_ASSERT_INT_WITHIN(1, expected, actual);
+      if (expected!=actual) {
+        ++mismatches;
+      }
+      ++count;
+    }
+  }
+  char szMsg[64];
+  sprintf(szMsg, "%u of %u results differ", (unsigned)mismatches, (unsigned)count);
+  TEST_MESSAGE(szMsg);
+  TEST_ASSERT_LESS_THAN(count / 1000U, mismatches);
+}
+
+// Run time ranges that change between calls: the cached scale (on AVR) must follow them
+static void test_fast_map_float_changing_ranges(void)
+{
+  volatile float outMax = 5.0F;
+  const fast_float_mapper<uint16_t, float> mapperA(0, 1023, 0.0F, 5.0F);
+  const fast_float_mapper<uint16_t, float> mapperB(0, 1023, 0.0F, 3.3F);
+  const fast_float_mapper<uint16_t, float> mapperC(0, 1023, 0.0F, -0.0F);
+  for (uint16_t in = 0; in <= 1023U; in = (uint16_t)(in + 31U)) {
+    outMax = 5.0F;
+    TEST_ASSERT_EQUAL_FLOAT(mapperA.map(in), fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, (float)outMax));
+    TEST_ASSERT_EQUAL_FLOAT(mapperA.map(in), fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, (float)outMax));
+    outMax = 3.3F;
+    TEST_ASSERT_EQUAL_FLOAT(mapperB.map(in), fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, (float)outMax));
+    outMax = -0.0F;
+    TEST_ASSERT_EQUAL_FLOAT(mapperC.map(in), fast_map(in, (uint16_t)0, (uint16_t)1023, 0.0F, (float)outMax));
+  }
+}
+
+void test_fast_map_float(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_map_float_float);
+    RUN_TEST(test_fast_map_float_integral_in);
+    RUN_TEST(test_fast_map_float_integral_out);
+    RUN_TEST(test_fast_map_float_integral_out_rate);
+    RUN_TEST(test_fast_map_float_changing_ranges);
+  }
+}
@@ -0,0 +1,62 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-iterator.h"
+#include "test_utils.h"
+
+// Step the iterator & check every output against fast_map()
+template <typename TIn, typename TOut>
+static void assert_fast_map_iterator(TIn start, typename fast_map_iterator<TIn, TOut>::step_t step, uint16_t steps,
+                                     TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+  fast_map_iterator<TIn, TOut> iterator(start, step, inMin, inMax, outMin, outMax);
+  TIn in = start;
+  for (uint16_t index = 0; index <= steps; ++index) {
+    char szMsg[64];
+    sprintf(szMsg, "Step %" PRIu16 ", In %" PRId32, index, (int32_t)in);
+    TEST_ASSERT_EQUAL_MESSAGE(in, iterator.input(), szMsg);
+    TEST_ASSERT_EQUAL_MESSAGE(fast_map(in, inMin, inMax, outMin, outMax), iterator.value(), szMsg);
+    if (index<steps) {
+      const TOut next = iterator.next();
+      in = (TIn)(in + step);
+      TEST_ASSERT_EQUAL_MESSAGE(iterator.value(), next, szMsg);
+    }
+  }
+}
+
+static void test_fast_map_iterator_U8xU8(void)
+{
+  // Every input, both directions
+  assert_fast_map_iterator<uint8_t, uint8_t>(0, 1, UINT8_MAX, 0, UINT8_MAX, 0, 100);
+  assert_fast_map_iterator<uint8_t, uint8_t>(UINT8_MAX, -1, UINT8_MAX, 0, UINT8_MAX, 0, 100);
+  // Inverted ranges, out of range inputs, large steps
+  assert_fast_map_iterator<uint8_t, uint8_t>(3, 7, 36, 233, 10, 0, UINT8_MAX);
+  assert_fast_map_iterator<uint8_t, uint8_t>(250, -13, 19, 100, 200, 200, 3);
+  assert_fast_map_iterator<uint8_t, uint8_t>(0, UINT8_MAX, 1, 1, 2, 0, UINT8_MAX);
+}
+
+static void test_fast_map_iterator_S16xS16(void)
+{
+  // Crosses inMin, in both directions & with both range directions
+  assert_fast_map_iterator<int16_t, int16_t>(-20000, 37, 1000, -1500, -11123, 1200, 5000);
+  assert_fast_map_iterator<int16_t, int16_t>(20000, -331, 120, -1500, 11123, 5000, -1200);
+  assert_fast_map_iterator<int16_t, int16_t>(-1500, 1, 500, -1500, -1000, 0, 30000);
+  assert_fast_map_iterator<int16_t, int16_t>(-1500, -1, 500, -1500, -1000, 0, 30000);
+  // Zero step
+  assert_fast_map_iterator<int16_t, int16_t>(77, 0, 10, 0, 1000, -100, 100);
+}
+
+static void test_fast_map_iterator_mixed(void)
+{
+  assert_fast_map_iterator<uint16_t, uint8_t>(0, 4, 1023, 0, 4092, 0, 100);
+  assert_fast_map_iterator<int8_t, int16_t>(INT8_MIN, 1, UINT8_MAX, 3, 123, -23579, -15973);
+  assert_fast_map_iterator<uint8_t, uint16_t>(0, 1, UINT8_MAX, 255, 0, 0, UINT16_MAX);
+  assert_fast_map_iterator<uint32_t, uint32_t>(5, 3999999L, 1000, 5, 4000000000UL, 4000000000UL, 5);
+  assert_fast_map_iterator<int32_t, int8_t>(2000000000L, -9999991L, 400, -2000000000L, 2000000000L, -100, 110);
+}
+
+void test_fast_map_iterator(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_map_iterator_U8xU8);
+    RUN_TEST(test_fast_map_iterator_S16xS16);
+    RUN_TEST(test_fast_map_iterator_mixed);
+  }
+}
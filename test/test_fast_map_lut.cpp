@@ -0,0 +1,50 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-lut.h"
+#include "test_utils.h"
+
+template <typename TLut, int32_t inMin, int32_t inMax, int32_t outMin, int32_t outMax>
+static void assert_fast_map_lut(void) {
+  typedef fast_map_impl::narrowest_integral_t<outMin, outMax> U;
+  for (uint16_t in = 0; in <= UINT8_MAX; ++in) {
+    U expected = (U)map(in, inMin, inMax, outMin, outMax);
+    char szMsg[256];
+    sprintf(szMsg, "In %" PRIu16 ", InMin %" PRId32 ", InMax %" PRId32 ", OutMin %" PRId32 ", OutMax %" PRId32, 
+      in, inMin, inMax, outMin, outMax);
+    TEST_ASSERT_EQUAL_MESSAGE(expected, TLut::map((uint8_t)in), szMsg);  
+  }
+}
+
+static void test_fast_map_lut_U8xU8(void)
+{
+  assert_fast_map_lut<fast_map_lut<3, 233, 0, 255>, 3, 233, 0, 255>();
+  assert_fast_map_lut<fast_map_lut<233, 3, 0, 255>, 233, 3, 0, 255>();
+  assert_fast_map_lut<fast_map_lut<0, 255, 100, 0>, 0, 255, 100, 0>();
+}
+
+static void test_fast_map_lut_U8xS16(void)
+{
+  assert_fast_map_lut<fast_map_lut<3, 233, -23579, 15973>, 3, 233, -23579, 15973>();
+  assert_fast_map_lut<fast_map_lut<233, 3, -23579, 15973>, 233, 3, -23579, 15973>();
+}
+
+static void test_fast_map_lut_U8xU32(void)
+{
+  assert_fast_map_lut<fast_map_lut<0, 200, 0, 8000000L>, 0, 200, 0, 8000000L>();
+}
+
+static void test_fast_map_lut_compact(void)
+{
+  typedef fast_map_lut<10, 100, 0, 1000, uint16_t, 10, 100> lut_t;
+  TEST_ASSERT_EQUAL(91U, sizeof(lut_t::storage_t::table)/sizeof(lut_t::storage_t::table[0]));
+  assert_fast_map_lut<lut_t, 10, 100, 0, 1000>();
+}
+
+void test_fast_map_lut(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_map_lut_U8xU8);
+    RUN_TEST(test_fast_map_lut_U8xS16);
+    RUN_TEST(test_fast_map_lut_U8xU32);
+    RUN_TEST(test_fast_map_lut_compact);
+  }
+}
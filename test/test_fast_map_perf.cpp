@@ -1,9 +1,18 @@
 #include <Arduino.h>
 #include <unity.h>
 #include "avr-fast-map.h"
+#include "avr-fast-map-lut.h"
+#include "avr-fast-map-curve.h"
+#include "avr-fast-map-table2d.h"
+#include "avr-fast-map-iterator.h"
+#include "avr-fast-map-cached.h"
+#include "avr-fast-map-compose.h"
+#include "avr-fast-map-bank.h"
+#include "avr-fast-map-float.h"
 #include "lambda_timer.hpp"
 #include "test_utils.h"
 #include "unity_print_timers.hpp"
+#include "cycle_counter.hpp"
 
 
 static void test_fastmap_perf_8x8_map(void)
@@ -90,11 +99,757 @@ static void test_fastmap_perf_16x16_map(void)
 #endif
 }
 
+static void test_fastmap_perf_10bit_adc(void)
+{
+  // 10-bit ADC: the product fits in 16 bits
+  const uint16_t iters = 20;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint16_t step = 1;
+  const uint16_t outMin = 0;
+  const uint16_t outMax = 60;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+static void test_fastmap_perf_10bit_adc_reciprocal(void)
+{
+  // 10-bit ADC (or the largest range in the table) to a 16-bit output: a 24 (or 
+  // 32) bit product divided by the input range, versus the reciprocal table's 2 
+  // multiply steps
+  const uint16_t iters = 20;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = FAST_MAP_RECIPROCAL_LUT;
+  const uint16_t step = 1;
+  const uint16_t outRange = 50000;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += (uint16_t)fast_map_impl::mulDiv(index, (uint16_t)outRange, (uint16_t)inMax); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map_impl::reciprocalMulDiv(index, (uint16_t)outRange, (uint16_t)inMax); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+#endif
+
+// Oversampled 10-bit ADC: average then fast_map(), versus fast_map_accumulated().
+// The results aren't the same: averaging first truncates the mean, so its outputs 
+// can only be lower.
+static void test_fastmap_perf_accumulated_10(void)
+{
+  const uint16_t iters = 2;
+  const uint8_t count = 10;
+  const uint16_t sumMin = 0;
+  const uint16_t sumMax = 1023U*count;
+  const uint16_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 100;
+
+  auto nativeTest = [] (uint16_t sum, uint32_t &checkSum) { checkSum += fast_map((uint16_t)(sum/count), (uint16_t)0, (uint16_t)1023, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t sum, uint32_t &checkSum) { checkSum += fast_map_accumulated(sum, count, (uint16_t)0, (uint16_t)1023, outMin, outMax); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, sumMin, sumMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_GREATER_OR_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// A power of 2 count: averaging is a shift, so this is about accuracy, not speed
+static void test_fastmap_perf_accumulated_16(void)
+{
+  const uint16_t iters = 2;
+  const uint16_t sumMin = 0;
+  const uint16_t sumMax = 1023U*16U;
+  const uint16_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 100;
+
+  auto nativeTest = [] (uint16_t sum, uint32_t &checkSum) { checkSum += fast_map((uint16_t)(sum/16U), (uint16_t)0, (uint16_t)1023, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t sum, uint32_t &checkSum) { checkSum += fast_map_accumulated<16>(sum, (uint16_t)0, (uint16_t)1023, outMin, outMax); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, sumMin, sumMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_GREATER_OR_EQUAL(comparison.timeA.result, comparison.timeB.result);
+}
+
+static void test_fastmap_perf_12bit_adc(void)
+{
+  // 12-bit ADC: the product needs more than 16 bits
+  const uint16_t iters = 5;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 4095;
+  const uint16_t step = 1;
+  const uint16_t outMin = 0;
+  const uint16_t outMax = 1000;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_32x32_map(void)
+{
+  // E.g. timer ticks to RPM: 32-bit types, but the product fits in 32 bits
+  const uint16_t iters = 100;
+  const uint32_t inMin = 0;
+  const uint32_t inMax = 100000;
+  const uint32_t step = 997;
+  const uint32_t outMin = 0;
+  const uint32_t outMax = 20000;
+
+  auto nativeTest = [] (uint32_t index, uint32_t &checkSum) { checkSum += map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint32_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto comparison = compare_executiontime<uint32_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_16x16_mapper(void)
+{
+  const uint16_t iters = 50;
+  const uint16_t inMin = 1521;
+  const uint16_t inMax = 53333;
+  const uint16_t step = 331;
+  const uint16_t outMin = (UINT16_MAX/10)*2;
+  const uint16_t outMax = (UINT16_MAX/10)*3;
+  static const fast_mapper<uint16_t, uint16_t> mapper(inMin, inMax, outMin, outMax);
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += mapper.map(index); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_8x8_mapper(void)
+{
+  const uint16_t iters = 50;
+  const uint8_t inMin = 3;
+  const uint8_t inMax = 233;
+  const uint8_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 255;
+  static const fast_mapper<uint8_t, uint8_t> mapper(inMin, inMax, outMin, outMax);
+
+  auto nativeTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += mapper.map(index); };
+  auto comparison = compare_executiontime<uint8_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_16x8_const(void)
+{
+  const uint16_t iters = 10;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint16_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 255;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += fast_map<inMin, inMax, outMin, outMax>(index); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// 8-bit sensor => millivolts => kPa: 2 chained mappers versus 1 composed mapper
+static void test_fastmap_perf_8x8_composed_mapper(void)
+{
+  const uint16_t iters = 100;
+  const uint8_t inMin = 0;
+  const uint8_t inMax = 255;
+  const uint8_t step = 1;
+  static const fast_mapper<uint8_t, uint16_t> toMillivolts(inMin, inMax, 0, 5000);
+  static const fast_mapper<uint16_t, uint8_t> toKpa(500, 4500, 0, 100);
+  // The scaled input (0 to 12750) fits in 16 bits
+  static const fast_composed_mapper<uint8_t, uint8_t, int16_t> composed(fast_map_compose({ inMin, inMax, 0, 5000 }, { 500, 4500, 0, 100 }));
+
+  // Stay within the second stage's input range: 26 * 5000/255 > 500
+  auto nativeTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += toKpa.map(toMillivolts.map(index)); };
+  auto optimizedTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += composed.map(index); };
+  auto comparison = compare_executiontime<uint8_t, uint32_t>(iters, 26, 229, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Chained maps truncate at each stage
+  TEST_ASSERT_GREATER_OR_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// 12-bit ADC => millivolts => temperature => display units: 3 chained constant maps
+// versus 1 composed constant map
+static void test_fastmap_perf_16x16_composed_const(void)
+{
+  const uint16_t iters = 5;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 4095;
+  const uint16_t step = 1;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) {
+    checkSum += fast_map<-400, 1250, 320, 2570>(fast_map<0, 3300, -400, 1250>(fast_map<inMin, inMax, 0, 3300>(index)));
+  };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) {
+    checkSum += fast_map_composed<inMin, inMax, 0, 3300,  0, 3300, -400, 1250,  -400, 1250, 320, 2570>(index);
+  };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Chained maps truncate at each stage
+  TEST_ASSERT_GREATER_OR_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// 16 sensor channels, each with its own ranges: fast_map() with the ranges in an
+// array of structs versus a bank with the per-range work (including the reciprocal)
+// done up front
+static void test_fastmap_perf_16x8_bank(void)
+{
+  const uint16_t iters = 2;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint16_t step = 1;
+  struct channel_ranges { uint16_t inMin; uint16_t inMax; uint8_t outMin; uint8_t outMax; };
+  static channel_ranges channels[16];
+  static fast_map_bank<16, uint16_t, uint8_t, true> bank;
+  for (uint8_t channel = 0; channel < 16U; ++channel) {
+    channels[channel] = { (uint16_t)(channel*7U), (uint16_t)(1023U-(channel*11U)), (uint8_t)(channel*3U), (uint8_t)(255U-channel) };
+    bank.set(channel, channels[channel].inMin, channels[channel].inMax, channels[channel].outMin, channels[channel].outMax);
+  }
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { 
+    for (uint8_t channel = 0; channel < 16U; ++channel) {
+      const channel_ranges &ranges = channels[channel];
+      checkSum += fast_map(index, ranges.inMin, ranges.inMax, ranges.outMin, ranges.outMax); 
+    }
+  };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { 
+    for (uint8_t channel = 0; channel < 16U; ++channel) {
+      checkSum += bank.map(channel, index); 
+    }
+  };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// The usual float formula: a soft-float division per call on AVR
+template <typename TIn, typename TOut>
+static TOut naive_float_map(TIn in, TIn inMin, TIn inMax, TOut outMin, TOut outMax) {
+  return (TOut)(((float)in - (float)inMin) * ((float)outMax - (float)outMin) / ((float)inMax - (float)inMin) + (float)outMin);
+}
+
+// 10-bit ADC => volts, constant ranges: the scale is computed at compile time
+static void test_fastmap_perf_float_const(void)
+{
+  const uint16_t iters = 2;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint16_t step = 1;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += (uint32_t)(naive_float_map(index, inMin, inMax, 0.0F, 5.0F) * 1000.0F); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += (uint32_t)(fast_map(index, inMin, inMax, 0.0F, 5.0F) * 1000.0F); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Float rounding: a few results can differ by 1 
+  TEST_ASSERT_UINT_WITHIN(16U, comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// Temperature => PWM duty, ranges set at run time
+static void test_fastmap_perf_float_mapper(void)
+{
+  const uint16_t iters = 2;
+  const uint16_t step = 1;
+  static float tempMin = -40.0F;
+  static float tempMax = 150.0F;
+  static const fast_float_mapper<float, uint8_t> mapper(tempMin, tempMax, 0, 255);
+
+  // Index is tenths of a degree
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += naive_float_map((float)index * 0.1F - 40.0F, tempMin, tempMax, (uint8_t)0, (uint8_t)255); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += mapper.map((float)index * 0.1F - 40.0F); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, 0, 1900, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Float rounding: a few results can differ by 1 
+  TEST_ASSERT_UINT_WITHIN(16U, comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_16x8_buffer(void)
+{
+  const uint16_t iters = 50;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 255;
+  static uint16_t inBuffer[128];
+  static uint8_t outBuffer[sizeof(inBuffer)/sizeof(inBuffer[0])];
+  const size_t n = sizeof(inBuffer)/sizeof(inBuffer[0]);
+  for (uint8_t i = 0; i < n; ++i)
+  {
+    inBuffer[i] = (uint16_t)(i * 8U);
+  }
+
+  auto nativeTest = [] (uint32_t &checkSum) { 
+    for (size_t i = 0; i < n; ++i) { outBuffer[i] = fast_map(inBuffer[i], inMin, inMax, outMin, outMax); }
+    checkSum += outBuffer[n-1];
+  };
+  auto optimizedTest = [] (uint32_t &checkSum) { 
+    fast_map_n(inBuffer, outBuffer, n, inMin, inMax, outMin, outMax);
+    checkSum += outBuffer[n-1];
+  };
+  auto comparison = compare_executiontime<uint32_t>(iters, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_8x8_lut(void)
+{
+  const uint16_t iters = 50;
+  const uint8_t inMin = 3;
+  const uint8_t inMax = 233;
+  const uint8_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 255;
+
+  auto nativeTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += fast_map(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += fast_map_lut<inMin, inMax, outMin, outMax>::map(index); };
+  auto comparison = compare_executiontime<uint8_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static const int16_t curveAxis[] = { -4000, -3000, -1000, -500, -20, 0, 10, 100, 250, 800, 1000, 1500, 3000, 3001, 5000, 7000 };
+static const int16_t curveValues[] = { 50, -20, 400, 400, 300, 0, -100, -3000, 3000, 16000, -16000, 0, 1, 2, 500, 900 };
+
+static int16_t naive_curve_map(int16_t in) {
+  const uint8_t N = sizeof(curveAxis)/sizeof(curveAxis[0]);
+  if (in<=curveAxis[0]) { return curveValues[0]; }
+  if (in>=curveAxis[N-1]) { return curveValues[N-1]; }
+  uint8_t bin = 0;
+  while (in>curveAxis[bin+1]) { ++bin; }
+  return (int16_t)map(in, curveAxis[bin], curveAxis[bin+1], curveValues[bin], curveValues[bin+1]);
+}
+
+static void test_fastmap_perf_curve(void)
+{
+  // Slowly changing input, so most lookups hit the cached bin
+  const uint16_t iters = 2;
+  const int16_t inMin = -5000;
+  const int16_t inMax = 8000;
+  const int16_t step = 7;
+  static fast_curve<int16_t, int16_t, sizeof(curveAxis)/sizeof(curveAxis[0])> curve(curveAxis, curveValues);
+
+  auto nativeTest = [] (int16_t index, int32_t &checkSum) { checkSum += naive_curve_map(index); };
+  auto optimizedTest = [] (int16_t index, int32_t &checkSum) { checkSum += curve.map(index); };
+  auto comparison = compare_executiontime<int16_t, int32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_curve_random(void)
+{
+  // Random input: no benefit from the cache, so this measures the search
+  const uint16_t iters = 2;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 2000;
+  const uint16_t step = 1;
+  static fast_curve<int16_t, int16_t, sizeof(curveAxis)/sizeof(curveAxis[0])> curve(curveAxis, curveValues);
+
+  auto nativeTest = [] (uint16_t index, int32_t &checkSum) { checkSum += naive_curve_map((int16_t)(((index * 7919U) % 13000U) - 5000)); };
+  auto optimizedTest = [] (uint16_t index, int32_t &checkSum) { checkSum += curve.map((int16_t)(((index * 7919U) % 13000U) - 5000)); };
+  auto comparison = compare_executiontime<uint16_t, int32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static const uint16_t tableXAxis[] = { 500, 1000, 1500, 2000, 2500, 3000, 3500, 4000, 4500, 5000, 5500, 6000, 6500, 7000, 7500, 8000 };
+static const uint8_t tableYAxis[] = { 16, 26, 30, 36, 40, 46, 50, 56, 60, 66, 70, 76, 86, 90, 96, 100 };
+static uint8_t tableValues[16][16];
+
+static uint8_t naive_table_map(uint16_t x, uint8_t y) {
+  x = constrain(x, tableXAxis[0], tableXAxis[15]);
+  y = constrain(y, tableYAxis[0], tableYAxis[15]);
+  uint8_t xBin = 0;
+  while (x>tableXAxis[xBin+1]) { ++xBin; }
+  uint8_t yBin = 0;
+  while (y>tableYAxis[yBin+1]) { ++yBin; }
+  uint8_t lower = fast_map(x, tableXAxis[xBin], tableXAxis[xBin+1], tableValues[yBin][xBin], tableValues[yBin][xBin+1]);
+  uint8_t upper = fast_map(x, tableXAxis[xBin], tableXAxis[xBin+1], tableValues[yBin+1][xBin], tableValues[yBin+1][xBin+1]);
+  return fast_map(y, tableYAxis[yBin], tableYAxis[yBin+1], lower, upper);
+}
+
+static void test_fastmap_perf_table2d(void)
+{
+  // Engine speed changes slowly, load is constant: as per a real engine
+  const uint16_t iters = 4;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 9000;
+  const uint16_t step = 3;
+  for (uint8_t y = 0; y < 16; ++y) {
+    for (uint8_t x = 0; x < 16; ++x) {
+      tableValues[y][x] = (uint8_t)((x * 7919U) + (y * 104729U));
+    }
+  }
+  static fast_table2d<uint16_t, uint8_t, uint8_t, 16, 16> table(tableXAxis, tableYAxis, tableValues);
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += naive_table_map(index, 53); };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { checkSum += table.map(index, 53); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Results can differ by a few LSB (see fast_table2d), so allow a small tolerance
+  TEST_ASSERT_UINT_WITHIN(comparison.timeA.result/1000U, comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_table2d_constant(void)
+{
+  // Both inputs constant (E.g. idle): every call after the first returns the cached result
+  const uint16_t iters = 4;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 2000;
+  const uint16_t step = 1;
+  for (uint8_t y = 0; y < 16; ++y) {
+    for (uint8_t x = 0; x < 16; ++x) {
+      tableValues[y][x] = (uint8_t)((x * 7919U) + (y * 104729U));
+    }
+  }
+  static fast_table2d<uint16_t, uint8_t, uint8_t, 16, 16> table(tableXAxis, tableYAxis, tableValues);
+
+  auto nativeTest = [] (uint16_t, uint32_t &checkSum) { checkSum += naive_table_map(2750, 53); };
+  auto optimizedTest = [] (uint16_t, uint32_t &checkSum) { checkSum += table.map(2750, 53); };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  // Results can differ by a few LSB (see fast_table2d), so allow a small tolerance
+  TEST_ASSERT_UINT_WITHIN(comparison.timeA.result/100U, comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_16x16_constrain(void)
+{
+  // Half the inputs are outside the input range
+  const uint16_t iters = 50;
+  const uint16_t inMin = 1521;
+  const uint16_t inMax = 53333;
+  const uint16_t step = 331;
+  const uint16_t outMin = (UINT16_MAX/10)*2;
+  const uint16_t outMax = (UINT16_MAX/10)*3;
+
+  auto nativeTest = [] (uint16_t index, uint32_t &checkSum) { 
+    checkSum += constrain(fast_map((uint16_t)(index*2U), inMin, inMax, outMin, outMax), outMin, outMax); 
+  };
+  auto optimizedTest = [] (uint16_t index, uint32_t &checkSum) { 
+    checkSum += fast_map_constrain((uint16_t)(index*2U), inMin, inMax, outMin, outMax); 
+  };
+  auto comparison = compare_executiontime<uint16_t, uint32_t>(iters, 0, UINT16_MAX/2U, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_8x8_fixed(void)
+{
+  // Integer & Q8.8 results: 2 fast_map() calls versus 1 fast_map_fixed() call
+  const uint16_t iters = 50;
+  const uint8_t inMin = 3;
+  const uint8_t inMax = 233;
+  const uint8_t step = 1;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 255;
+
+  auto nativeTest = [] (uint8_t index, uint32_t &checkSum) { 
+    checkSum += fast_map(index, inMin, inMax, outMin, outMax);
+    checkSum += fast_map(index, inMin, inMax, (uint16_t)(outMin*256U), (uint16_t)(outMax*256U)); 
+  };
+  auto optimizedTest = [] (uint8_t index, uint32_t &checkSum) { 
+    const uint16_t fixed = fast_map_fixed(index, inMin, inMax, outMin, outMax);
+    checkSum += (fixed >> 8U) + fixed; 
+  };
+  auto comparison = compare_executiontime<uint8_t, uint32_t>(iters, inMin, inMax, step, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_8x16_unmap(void)
+{
+  // The inverse of a 16-bit to 8-bit map: expands the value
+  const uint16_t iters = 50;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 100;
+  static const fast_bimapper<uint16_t, uint8_t> mapper(inMin, inMax, outMin, outMax);
+
+  auto nativeTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += fast_unmap(index, inMin, inMax, outMin, outMax); };
+  auto optimizedTest = [] (uint8_t index, uint32_t &checkSum) { checkSum += mapper.unmap(index); };
+  auto comparison = compare_executiontime<uint8_t, uint32_t>(iters, outMin, outMax, 1, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_8x16_iterator(void)
+{
+  // E.g. an LED fade: the per-step fast_map() loop that measure_executiontime() 
+  // runs, against an iterator over the same inputs
+  const uint16_t iters = 50;
+  const uint8_t inMin = 3;
+  const uint8_t inMax = 233;
+  const uint16_t outMin = (UINT16_MAX/10)*2;
+  const uint16_t outMax = (UINT16_MAX/10)*3;
+
+  auto nativeTest = [] (uint32_t &checkSum) { 
+    for (uint8_t in = inMin; in < inMax; ++in) { checkSum += fast_map(in, inMin, inMax, outMin, outMax); }
+  };
+  auto optimizedTest = [] (uint32_t &checkSum) { 
+    fast_map_iterator<uint8_t, uint16_t> iterator(inMin, 1, inMin, inMax, outMin, outMax);
+    for (uint8_t in = inMin; in < inMax; ++in) { checkSum += iterator.value(); iterator.next(); }
+  };
+  auto comparison = compare_executiontime<uint32_t>(iters, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+static void test_fastmap_perf_16x16_iterator(void)
+{
+  // Axis generation: large steps across an inverted range
+  const uint16_t iters = 50;
+  const int16_t inMin = -1500;
+  const int16_t inMax = 30000;
+  const int16_t step = 331;
+  const int16_t outMin = 5000;
+  const int16_t outMax = -1200;
+
+  auto nativeTest = [] (uint32_t &checkSum) { 
+    for (int16_t in = inMin; in < inMax; in = (int16_t)(in + step)) { checkSum += (uint16_t)fast_map(in, inMin, inMax, outMin, outMax); }
+  };
+  auto optimizedTest = [] (uint32_t &checkSum) { 
+    fast_map_iterator<int16_t, int16_t> iterator(inMin, step, inMin, inMax, outMin, outMax);
+    for (int16_t in = inMin; in < inMax; in = (int16_t)(in + step)) { checkSum += (uint16_t)iterator.value(); iterator.next(); }
+  };
+  auto comparison = compare_executiontime<uint32_t>(iters, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
+// A polled ADC reading: it changes about 1 call in 20, with +/-1 jitter
+static uint16_t adc_sample(uint16_t index) {
+  const uint16_t reading = (uint16_t)(100U + ((index / 20U) * 37U));
+  return (index % 20U)==10U ? (uint16_t)(reading + 1U) : reading;
+}
+
+static void test_fastmap_perf_16x8_cached(void)
+{
+  const uint16_t iters = 20;
+  const uint16_t samples = 400;
+  const uint16_t inMin = 0;
+  const uint16_t inMax = 1023;
+  const uint8_t outMin = 0;
+  const uint8_t outMax = 100;
+  static fast_cached_mapper<uint16_t, uint8_t> mapper(inMin, inMax, outMin, outMax);
+#if defined(FAST_MAP_STATISTICS)
+  mapper.reset_statistics();
+#endif
+
+  auto nativeTest = [] (uint32_t &checkSum) { 
+    for (uint16_t i = 0; i < samples; ++i) { checkSum += fast_map(adc_sample(i), inMin, inMax, outMin, outMax); }
+  };
+  auto optimizedTest = [] (uint32_t &checkSum) { 
+    for (uint16_t i = 0; i < samples; ++i) { checkSum += mapper.map(adc_sample(i)); }
+  };
+  auto comparison = compare_executiontime<uint32_t>(iters, nativeTest, optimizedTest);
+  
+  MESSAGE_TIMERS(comparison.timeA.timer, comparison.timeB.timer);
+  TEST_ASSERT_EQUAL(comparison.timeA.result, comparison.timeB.result);
+
+#if defined(FAST_MAP_STATISTICS)
+  // Hit rate: how the timed mapper answered each call. Per 20 samples, adc_sample()
+  // has one jump (a miss) & a +1/-1 jitter (2 single steps): the rest are hits.
+  const fast_cached_mapper<uint16_t, uint8_t>::statistics_t &statistics = mapper.statistics();
+  const uint16_t calls = (uint16_t)(iters * samples);
+  char szMsg[128];
+  sprintf(szMsg, "Cache hits %u, single steps %u, misses %u (hit rate %u%%)", 
+          (unsigned)statistics.hits, (unsigned)statistics.steps, (unsigned)statistics.misses, 
+          (unsigned)((statistics.hits * 100UL) / calls));
+  TEST_MESSAGE(szMsg);
+  TEST_ASSERT_EQUAL_UINT16(calls, (uint16_t)(statistics.hits + statistics.steps + statistics.misses));
+  TEST_ASSERT_EQUAL_UINT16(calls / 20U, statistics.misses);
+  TEST_ASSERT_EQUAL_UINT16((calls / 20U) * 2U, statistics.steps);
+  TEST_ASSERT_EQUAL_UINT16(calls - ((calls / 20U) * 3U), statistics.hits);
+#endif
+
+#if defined(CYCLE_COUNTER_AVAILABLE)
+  // Cycles for each kind of call
+  volatile uint16_t in = 500U;
+  volatile uint8_t result;
+  fast_cached_mapper<uint16_t, uint8_t> cycleMapper(inMin, inMax, outMin, outMax);
+  result = cycleMapper.map(in);
+  const uint16_t hitCycles = measure_cycles([&] { result = cycleMapper.map(in); });
+  in = 501U;
+  const uint16_t stepCycles = measure_cycles([&] { result = cycleMapper.map(in); });
+  in = 900U;
+  const uint16_t missCycles = measure_cycles([&] { result = cycleMapper.map(in); });
+  const uint16_t fastMapCycles = measure_cycles([&] { result = fast_map((uint16_t)in, inMin, inMax, outMin, outMax); });
+  char szMsg[128];
+  sprintf(szMsg, "Cycles: hit %u, single step %u, miss %u, fast_map() %u", 
+          (unsigned)hitCycles, (unsigned)stepCycles, (unsigned)missCycles, (unsigned)fastMapCycles);
+  TEST_MESSAGE(szMsg);
+  TEST_ASSERT_LESS_THAN(fastMapCycles, hitCycles);
+  TEST_ASSERT_LESS_THAN(fastMapCycles, stepCycles);
+#endif
+
+#if defined(__AVR__) // We only expect a speed improvement on AVR
+  TEST_ASSERT_LESS_THAN(comparison.timeA.timer.duration_micros(), comparison.timeB.timer.duration_micros());
+#endif
+}
+
 void test_fast_map_perf(void) {
   SET_UNITY_FILENAME() {
     RUN_TEST(test_fastmap_perf_8x8_map);
     RUN_TEST(test_fastmap_perf_16x16_map);
+    RUN_TEST(test_fastmap_perf_10bit_adc);
+#if defined(FAST_MAP_RECIPROCAL_LUT)
+    RUN_TEST(test_fastmap_perf_10bit_adc_reciprocal);
+#endif
+    RUN_TEST(test_fastmap_perf_12bit_adc);
+    RUN_TEST(test_fastmap_perf_accumulated_10);
+    RUN_TEST(test_fastmap_perf_accumulated_16);
+    RUN_TEST(test_fastmap_perf_32x32_map);
     RUN_TEST(test_fastmap_perf_8x16_map);
     RUN_TEST(test_fastmap_perf_8x8_16x16);
+    RUN_TEST(test_fastmap_perf_16x16_mapper);
+    RUN_TEST(test_fastmap_perf_8x8_mapper);
+    RUN_TEST(test_fastmap_perf_16x8_const);
+    RUN_TEST(test_fastmap_perf_8x8_composed_mapper);
+    RUN_TEST(test_fastmap_perf_16x16_composed_const);
+    RUN_TEST(test_fastmap_perf_16x8_buffer);
+    RUN_TEST(test_fastmap_perf_16x8_bank);
+    RUN_TEST(test_fastmap_perf_float_const);
+    RUN_TEST(test_fastmap_perf_float_mapper);
+    RUN_TEST(test_fastmap_perf_8x8_lut);
+    RUN_TEST(test_fastmap_perf_curve);
+    RUN_TEST(test_fastmap_perf_curve_random);
+    RUN_TEST(test_fastmap_perf_table2d);
+    RUN_TEST(test_fastmap_perf_table2d_constant);
+    RUN_TEST(test_fastmap_perf_16x16_constrain);
+    RUN_TEST(test_fastmap_perf_8x8_fixed);
+    RUN_TEST(test_fastmap_perf_8x16_unmap);
+    RUN_TEST(test_fastmap_perf_8x16_iterator);
+    RUN_TEST(test_fastmap_perf_16x16_iterator);
+    RUN_TEST(test_fastmap_perf_16x8_cached);
   }
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-shared.h"
+#include "test_utils.h"
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+#endif
+
+// 2 calibrations, different enough that a mix of the 2 (a torn read) gives a
+// result that neither would
+struct calibration {
+  uint16_t inMin;
+  uint16_t inMax;
+  int16_t outMin;
+  int16_t outMax;
+};
+static const calibration calibrations[2] = {
+  { 0, 1023, -500, 500 },
+  { 1023, 100, 3000, 2000 },
+};
+
+static void publish_calibration(fast_shared_mapper<uint16_t, int16_t> &mapper, uint8_t index) {
+  const calibration &cal = calibrations[index];
+  mapper.set_ranges(cal.inMin, cal.inMax, cal.outMin, cal.outMax);
+}
+
+static void test_fast_shared_mapper_publish(void)
+{
+  fast_shared_mapper<uint16_t, int16_t> mapper(0, 1023, -500, 500);
+
+  for (uint8_t publish = 0; publish < 5U; ++publish) {
+    const calibration &cal = calibrations[publish & 1U];
+    publish_calibration(mapper, publish & 1U);
+    for (uint16_t in = 0; in <= 1100U; in = (uint16_t)(in + 7U)) {
+      TEST_ASSERT_EQUAL_INT16(fast_map(in, cal.inMin, cal.inMax, cal.outMin, cal.outMax), mapper.map(in));
+    }
+  }
+}
+
+#if defined(__AVR__)
+
+static bool is_calibrated_result(uint16_t in, int16_t result) {
+  for (uint8_t index = 0; index < 2U; ++index) {
+    const calibration &cal = calibrations[index];
+    if (result==fast_map(in, cal.inMin, cal.inMax, cal.outMin, cal.outMax)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Stress tests: Timer2 fires an interrupt every few hundred cycles, which either
+// reads from or publishes to the mapper while the main loop does the opposite.
+static fast_shared_mapper<uint16_t, int16_t> *volatile isrMapper;
+static volatile bool isrWrites;
+static volatile uint16_t isrCalls;
+static volatile uint16_t isrErrors;
+static uint16_t isrInput;
+static uint8_t isrCalibration;
+
+ISR(TIMER2_COMPA_vect) {
+  if (isrWrites) {
+    isrCalibration = (uint8_t)(isrCalibration ^ 1U);
+    publish_calibration(*isrMapper, isrCalibration);
+  } else {
+    isrInput = (uint16_t)((isrInput + 97U) & 1023U);
+    if (!is_calibrated_result(isrInput, isrMapper->map(isrInput))) {
+      ++isrErrors;
+    }
+  }
+  ++isrCalls;
+}
+
+// Timer2 in CTC mode: interrupt every (top+1)*prescale cycles
+static void start_stress_timer(uint8_t top, uint8_t prescaleBits) {
+  isrCalls = 0;
+  isrErrors = 0;
+  TCCR2B = 0;
+  TCCR2A = _BV(WGM21);
+  TCNT2 = 0;
+  OCR2A = top;
+  TIFR2 = _BV(OCF2A);
+  TIMSK2 = _BV(OCIE2A);
+  TCCR2B = prescaleBits;
+}
+
+static void stop_stress_timer(void) {
+  TCCR2B = 0;
+  TIMSK2 = 0;
+  TCCR2A = 0;
+}
+
+// Readers in the ISR, main loop publishes
+static void test_fast_shared_mapper_isr_reader(void)
+{
+  static fast_shared_mapper<uint16_t, int16_t> mapper(0, 1023, -500, 500);
+  isrMapper = &mapper;
+  isrWrites = false;
+
+  start_stress_timer(249, _BV(CS21)); // Every 2000 cycles
+  for (uint16_t publish = 0; publish < 2000U; ++publish) {
+    publish_calibration(mapper, (uint8_t)(publish & 1U));
+  }
+  stop_stress_timer();
+
+  char szMsg[64];
+  sprintf(szMsg, "ISR map() calls %u", (unsigned)isrCalls);
+  TEST_MESSAGE(szMsg);
+  TEST_ASSERT_GREATER_THAN(1000U, isrCalls);
+  TEST_ASSERT_EQUAL_UINT16(0, isrErrors);
+}
+
+// ISR publishes, main loop reads
+static void test_fast_shared_mapper_isr_writer(void)
+{
+  static fast_shared_mapper<uint16_t, int16_t> mapper(0, 1023, -500, 500);
+  isrMapper = &mapper;
+  isrWrites = true;
+
+  uint16_t errors = 0;
+  uint16_t in = 0;
+  start_stress_timer(255, _BV(CS22)); // Every 16384 cycles
+  for (uint16_t read = 0; read < 30000U; ++read) {
+    in = (uint16_t)((in + 97U) & 1023U);
+    if (!is_calibrated_result(in, mapper.map(in))) {
+      ++errors;
+    }
+  }
+  stop_stress_timer();
+
+  char szMsg[64];
+  sprintf(szMsg, "ISR publishes %u", (unsigned)isrCalls);
+  TEST_MESSAGE(szMsg);
+  TEST_ASSERT_GREATER_THAN(100U, isrCalls);
+  TEST_ASSERT_EQUAL_UINT16(0, errors);
+}
+
+#else
+
+static void test_fast_shared_mapper_stress_unavailable(void) {
+  TEST_IGNORE_MESSAGE("Interrupt stress tests need AVR Timer2");
+}
+
+#endif
+
+void test_fast_map_shared(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_fast_shared_mapper_publish);
+#if defined(__AVR__)
+    RUN_TEST(test_fast_shared_mapper_isr_reader);
+    RUN_TEST(test_fast_shared_mapper_isr_writer);
+#else
+    RUN_TEST(test_fast_shared_mapper_stress_unavailable);
+#endif
+  }
+}
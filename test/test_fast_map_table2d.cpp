@@ -0,0 +1,120 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "avr-fast-map-table2d.h"
+#include "test_utils.h"
+
+static const uint16_t rpmAxis[] = { 500, 1000, 1500, 2000, 2500, 3000, 3500, 4000, 4500, 5000, 5500, 6000, 6500, 7000, 7500, 8000 };
+static const uint8_t loadAxis[] = { 16, 26, 30, 36, 40, 46, 50, 56, 60, 66, 70, 76, 86, 90, 96, 100 };
+static int16_t cellValues[16][16];
+
+static void fill_cells(void) {
+  for (uint8_t y = 0; y < 16; ++y) {
+    for (uint8_t x = 0; x < 16; ++x) {
+      cellValues[y][x] = (int16_t)((((x * 7919U) + (y * 104729U)) % 4000U) - 2000);
+    }
+  }
+}
+
+// Naive version: 2 linear searches & 3 map() calls
+static int16_t naive_table_map(uint16_t x, uint8_t y) {
+  x = constrain(x, rpmAxis[0], rpmAxis[15]);
+  y = constrain(y, loadAxis[0], loadAxis[15]);
+  uint8_t xBin = 0;
+  while (x>rpmAxis[xBin+1]) { ++xBin; }
+  uint8_t yBin = 0;
+  while (y>loadAxis[yBin+1]) { ++yBin; }
+  int16_t lower = (int16_t)map(x, rpmAxis[xBin], rpmAxis[xBin+1], cellValues[yBin][xBin], cellValues[yBin][xBin+1]);
+  int16_t upper = (int16_t)map(x, rpmAxis[xBin], rpmAxis[xBin+1], cellValues[yBin+1][xBin], cellValues[yBin+1][xBin+1]);
+  return (int16_t)map(y, loadAxis[yBin], loadAxis[yBin+1], lower, upper);
+}
+
+static void assert_table2d(fast_table2d<uint16_t, uint8_t, int16_t, 16, 16> &table, uint16_t x, uint8_t y) {
+  char szMsg[64];
+  sprintf(szMsg, "X %" PRIu16 ", Y %" PRIu8, x, y);
+  // Each of the 3 interpolations can truncate by 1
+  TEST_ASSERT_INT_WITHIN_MESSAGE(2, naive_table_map(x, y), table.map(x, y), szMsg);
+}
+
+static void test_table2d_break_points(void)
+{
+  fill_cells();
+  fast_table2d<uint16_t, uint8_t, int16_t, 16, 16> table(rpmAxis, loadAxis, cellValues);
+
+  for (uint8_t y = 0; y < 16; ++y) {
+    for (uint8_t x = 0; x < 16; ++x) {
+      TEST_ASSERT_EQUAL_INT16(cellValues[y][x], table.map(rpmAxis[x], loadAxis[y]));
+    }
+  }
+  // Clamped
+  TEST_ASSERT_EQUAL_INT16(cellValues[0][0], table.map(0, 0));
+  TEST_ASSERT_EQUAL_INT16(cellValues[15][15], table.map(UINT16_MAX, UINT8_MAX));
+  TEST_ASSERT_EQUAL_INT16(cellValues[0][15], table.map(UINT16_MAX, 0));
+  TEST_ASSERT_EQUAL_INT16(cellValues[15][0], table.map(0, UINT8_MAX));
+}
+
+static void test_table2d_interpolation(void)
+{
+  fill_cells();
+  fast_table2d<uint16_t, uint8_t, int16_t, 16, 16> table(rpmAxis, loadAxis, cellValues);
+
+  // Sweep slowly (mostly cached) and jump around (mostly searches)
+  for (uint16_t y = 0; y <= 110; y = (uint16_t)(y + 3U)) {
+    for (uint16_t x = 0; x <= 9000; x = (uint16_t)(x + 97U)) {
+      assert_table2d(table, x, (uint8_t)y);
+    }
+  }
+  for (uint16_t i = 0; i < 2000U; ++i) {
+    assert_table2d(table, (uint16_t)((i * 7919U) % 9000U), (uint8_t)((i * 31U) % 110U));
+  }
+}
+
+static void test_table2d_modify(void)
+{
+  fill_cells();
+  fast_table2d<uint16_t, uint8_t, int16_t, 16, 16> table(rpmAxis, loadAxis, cellValues);
+
+  TEST_ASSERT_EQUAL_INT16(cellValues[2][3], table.map(2000, 30));
+  table.row(2)[3] = 1234;
+  TEST_ASSERT_EQUAL_INT16(1234, table.map(2000, 30));
+  table.xAxis()[3] = 2100;
+  TEST_ASSERT_EQUAL_INT16(1234, table.map(2100, 30));
+  // Same inputs: the cached result
+  TEST_ASSERT_EQUAL_INT16(1234, table.map(2100, 30));
+  // Same inputs, but the axis moved: recomputed
+  table.xAxis()[3] = 2200;
+  TEST_ASSERT_INT_WITHIN(1, map(2100, 1500, 2200, cellValues[2][2], 1234), table.map(2100, 30));
+  table.row(2)[2] = 500;
+  TEST_ASSERT_INT_WITHIN(1, map(2100, 1500, 2200, 500, 1234), table.map(2100, 30));
+}
+
+// The cached cell reciprocal gives exactly the same weight as a division
+template <typename TAxis, uint16_t N>
+static void assert_axis_weights(const TAxis (&axis)[N], int32_t first, int32_t last) {
+  fast_map_impl::axis_position<TAxis, N> position;
+  for (int32_t in = first; in <= last; ++in) {
+    position.update(axis, (TAxis)in);
+    uint16_t expected = 0U;
+    if (in > axis[0] && in < axis[N-1U]) {
+      expected = (uint16_t)((((uint32_t)in - axis[position.bin()]) << 16U) / ((uint32_t)axis[position.bin()+1U] - axis[position.bin()]));
+    }
+    TEST_ASSERT_EQUAL_UINT16(expected, position.weight());
+  }
+}
+
+static void test_table2d_axis_weight(void)
+{
+  assert_axis_weights(rpmAxis, 0, 9000);
+  assert_axis_weights(loadAxis, 0, UINT8_MAX);
+  // Bins 1 wide & the widest possible bin
+  static const uint16_t edgeAxis[] = { 0, 1, 2, 3, 65535 };
+  assert_axis_weights(edgeAxis, 0, 65535);
+}
+
+void test_fast_map_table2d(void) {
+  SET_UNITY_FILENAME() {
+    RUN_TEST(test_table2d_break_points);
+    RUN_TEST(test_table2d_interpolation);
+    RUN_TEST(test_table2d_modify);
+    RUN_TEST(test_table2d_axis_weight);
+  }
+}
@@ -80,6 +80,83 @@ static void test_absDelta_s32(void) {
     TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, fast_map_impl::absDelta((int32_t)INT32_MAX, (int32_t)INT32_MIN));
 }
 
+static void test_fixedPointReciprocal_u8(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, fast_map_impl::fixedPointReciprocal((uint8_t)0, (uint8_t)7));
+    // ceil(65536/3)
+    TEST_ASSERT_EQUAL_UINT16(21846, fast_map_impl::fixedPointReciprocal((uint8_t)1, (uint8_t)3));
+    // ceil(254*65536/255)
+    TEST_ASSERT_EQUAL_UINT16(65279, fast_map_impl::fixedPointReciprocal((uint8_t)254, (uint8_t)255));
+}
+
+static void test_fixedPointReciprocal_u16(void) {
+    // ceil(2^32/1023)
+    TEST_ASSERT_EQUAL_UINT32(4198405UL, fast_map_impl::fixedPointReciprocal((uint16_t)1, (uint16_t)1023));
+    // ceil(65534*2^32/65535)
+    TEST_ASSERT_EQUAL_UINT32(4294901759UL, fast_map_impl::fixedPointReciprocal((uint16_t)65534, (uint16_t)65535));
+}
+
+static void test_multiplyHigh_u8(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, fast_map_impl::multiplyHigh((uint8_t)0, (uint16_t)UINT16_MAX));
+    TEST_ASSERT_EQUAL_UINT8(254, fast_map_impl::multiplyHigh((uint8_t)UINT8_MAX, (uint16_t)UINT16_MAX));
+    TEST_ASSERT_EQUAL_UINT8(1, fast_map_impl::multiplyHigh((uint8_t)3, (uint16_t)21846));
+}
+
+static void test_multiplyHigh_u16(void) {
+    TEST_ASSERT_EQUAL_UINT16(0, fast_map_impl::multiplyHigh((uint16_t)0, (uint32_t)UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT16(65534, fast_map_impl::multiplyHigh((uint16_t)UINT16_MAX, (uint32_t)UINT32_MAX));
+    TEST_ASSERT_EQUAL_UINT16(1, fast_map_impl::multiplyHigh((uint16_t)1023, (uint32_t)4198405UL));
+}
+
+static void test_mulDiv16(void) {
+    // Product fits in 16 bits
+    TEST_ASSERT_EQUAL_UINT32(60UL, fast_map_impl::mulDiv16(1023U, 60U, 1023U));
+    TEST_ASSERT_EQUAL_UINT32(29UL, fast_map_impl::mulDiv16(500U, 60U, 1023U));
+    TEST_ASSERT_EQUAL_UINT32(65025UL, fast_map_impl::mulDiv16(255U, 255U, 1U));
+    // Product wider than 16 bits
+    TEST_ASSERT_EQUAL_UINT32(100UL, fast_map_impl::mulDiv16(1023U, 100U, 1023U));
+    TEST_ASSERT_EQUAL_UINT32(65535UL, fast_map_impl::mulDiv16(UINT16_MAX, 256U, 256U));
+    TEST_ASSERT_EQUAL_UINT32(65535UL, fast_map_impl::mulDiv16(UINT16_MAX, UINT16_MAX, UINT16_MAX));
+    // Quotient wider than 16 bits
+    TEST_ASSERT_EQUAL_UINT32(4294836225UL, fast_map_impl::mulDiv16(UINT16_MAX, UINT16_MAX, 1U));
+}
+
+static void test_mulDiv32(void) {
+    // Product fits in 32 bits
+    TEST_ASSERT_EQUAL_UINT32(20000UL, fast_map_impl::mulDiv32(100000UL, 20000UL, 100000UL));
+    TEST_ASSERT_EQUAL_UINT32(1999UL, fast_map_impl::mulDiv32(99999UL, 20000UL, 1000000UL));
+    // 32x16 product wider than 32 bits, 16-bit divisor
+    TEST_ASSERT_EQUAL_UINT32(3999999999UL, fast_map_impl::mulDiv32(50000UL, 3999999999UL, 50000UL));
+    TEST_ASSERT_EQUAL_UINT32(2709133UL, fast_map_impl::mulDiv32(UINT32_MAX, 41UL, 65000UL));
+    TEST_ASSERT_EQUAL_UINT32(4294901759UL, fast_map_impl::mulDiv32(UINT32_MAX, UINT16_MAX, UINT16_MAX+1UL));
+    // 32x16 product wider than 32 bits, 32-bit divisor
+    TEST_ASSERT_EQUAL_UINT32(1234500UL, fast_map_impl::mulDiv32(4000000000UL, 12345UL, 40000UL*1000UL));
+    // 32x32 product
+    TEST_ASSERT_EQUAL_UINT32(2863311530UL, fast_map_impl::mulDiv32(UINT32_MAX, 2863311530UL, UINT32_MAX));
+    // Quotient overflows: same as the low 32 bits of a 64-bit division
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(((uint64_t)UINT32_MAX*60000U)/3U), fast_map_impl::mulDiv32(UINT32_MAX, 60000UL, 3UL));
+}
+
+#if defined(FAST_MAP_INT24)
+static void test_safeMultiply_24bit(void) {
+  // 16x8 products fit in 24 bits
+  static_assert(sizeof(fast_map_impl::safeMultiply((uint16_t)0, (uint8_t)0))==3, "16x8 products should be 24-bit");
+  static_assert(sizeof(fast_map_impl::safeMultiply((int8_t)0, (int16_t)0))==3, "16x8 products should be 24-bit");
+  static_assert(sizeof(fast_map_impl::safeMultiply((__uint24)0, (uint8_t)0))==4, "24x8 products should be 32-bit");
+  static_assert(sizeof(fast_map_impl::safeMultiply((__uint24)0, (__uint24)0))==8, "24x24 products should be 64-bit");
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)UINT16_MAX * UINT8_MAX, fast_map_impl::safeMultiply((uint16_t)UINT16_MAX, (uint8_t)UINT8_MAX));
+  TEST_ASSERT_EQUAL_INT32((int32_t)INT16_MIN * INT8_MAX, fast_map_impl::safeMultiply((int16_t)INT16_MIN, (int8_t)INT8_MAX));
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)0xFFFFFFUL * UINT8_MAX, fast_map_impl::safeMultiply((__uint24)0xFFFFFFUL, (uint8_t)UINT8_MAX));
+  TEST_ASSERT_EQUAL_UINT64((uint64_t)0xFFFFFFUL * 0xFFFFFFUL, fast_map_impl::safeMultiply((__uint24)0xFFFFFFUL, (__uint24)0xFFFFFFUL));
+}
+
+static void test_multiplyHigh_u24(void) {
+    const uint64_t recip = fast_map_impl::fixedPointReciprocal((__uint24)1UL, (__uint24)3UL);
+    // ceil(2^48 / 3)
+    TEST_ASSERT_EQUAL_UINT64(93824992236886ULL, recip);
+    TEST_ASSERT_EQUAL_UINT32(5592405UL, (uint32_t)fast_map_impl::multiplyHigh((__uint24)0xFFFFFFUL, recip));
+}
+#endif
+
 void test_fast_map_implementation(void) {
   SET_UNITY_FILENAME() {
     RUN_TEST(test_safeMultiply_u8u8);
@@ -94,5 +171,15 @@ void test_fast_map_implementation(void) {
     RUN_TEST(test_absDelta_s8);
     RUN_TEST(test_absDelta_s16);
     RUN_TEST(test_absDelta_s32);
+    RUN_TEST(test_fixedPointReciprocal_u8);
+    RUN_TEST(test_fixedPointReciprocal_u16);
+    RUN_TEST(test_multiplyHigh_u8);
+    RUN_TEST(test_multiplyHigh_u16);
+    RUN_TEST(test_mulDiv16);
+    RUN_TEST(test_mulDiv32);
+#if defined(FAST_MAP_INT24)
+    RUN_TEST(test_safeMultiply_24bit);
+    RUN_TEST(test_multiplyHigh_u24);
+#endif
   }
 }
\ No newline at end of file